@@ -0,0 +1,117 @@
+#include "Coastline.h"
+#include <algorithm>
+#include <cmath>
+
+void Coastline::Extract(const float* heights, int gridSize, float spacing, float level)
+{
+    segments.clear();
+    totalLength = 0.0f;
+    if (!heights || gridSize <= 0) return;
+
+    const int side = gridSize + 1;
+    const float half = gridSize * spacing * 0.5f;
+
+    // Corner order around a cell: 0 = (x, z), 1 = (x+1, z), 2 = (x+1, z+1), 3 = (x, z+1).
+    // Edge e joins corner e and corner (e + 1) % 4.
+    static const int kCornerX[4] = { 0, 1, 1, 0 };
+    static const int kCornerZ[4] = { 0, 0, 1, 1 };
+
+    for (int z = 0; z < gridSize; z++)
+    {
+        for (int x = 0; x < gridSize; x++)
+        {
+            float h[4];
+            int mask = 0;
+            for (int c = 0; c < 4; c++)
+            {
+                h[c] = heights[(z + kCornerZ[c]) * side + x + kCornerX[c]];
+                if (h[c] > level) mask |= 1 << c;
+            }
+            if (mask == 0 || mask == 15) continue;
+
+            auto edgePoint = [&](int e)
+                {
+                    int c0 = e, c1 = (e + 1) & 3;
+                    float t = (level - h[c0]) / (h[c1] - h[c0]);
+                    float px = x + kCornerX[c0] + (kCornerX[c1] - kCornerX[c0]) * t;
+                    float pz = z + kCornerZ[c0] + (kCornerZ[c1] - kCornerZ[c0]) * t;
+                    return glm::vec2(px * spacing - half, pz * spacing - half);
+                };
+
+            // Edges the contour crosses, in order. Saddles (two opposite land corners) are resolved
+            // by the cell centre: whichever pair of corners matches it is joined through the middle
+            // and the other two corners are cut off.
+            int edges[4];
+            int edgeCount = 0;
+            for (int e = 0; e < 4; e++)
+            {
+                bool in0 = (mask >> e) & 1;
+                bool in1 = (mask >> ((e + 1) & 3)) & 1;
+                if (in0 != in1) edges[edgeCount++] = e;
+            }
+
+            int pairs[2][2] = { { edges[0], edges[1] }, { -1, -1 } };
+            if (edgeCount == 4)
+            {
+                bool centreLand = (h[0] + h[1] + h[2] + h[3]) * 0.25f > level;
+                bool corner0Land = mask & 1;
+                if (centreLand == corner0Land)
+                {
+                    // cut off corners 1 and 3
+                    pairs[0][0] = 0; pairs[0][1] = 1;
+                    pairs[1][0] = 2; pairs[1][1] = 3;
+                }
+                else
+                {
+                    // cut off corners 0 and 2
+                    pairs[0][0] = 3; pairs[0][1] = 0;
+                    pairs[1][0] = 1; pairs[1][1] = 2;
+                }
+            }
+
+            // Uphill direction of the cell (bilinear gradient at the centre)
+            glm::vec2 grad(((h[1] - h[0]) + (h[2] - h[3])) * 0.5f / spacing,
+                ((h[3] - h[0]) + (h[2] - h[1])) * 0.5f / spacing);
+            float slope = glm::length(grad);
+
+            for (int p = 0; p < 2; p++)
+            {
+                if (pairs[p][0] < 0) break;
+
+                CoastSegment s;
+                s.a = edgePoint(pairs[p][0]);
+                s.b = edgePoint(pairs[p][1]);
+
+                glm::vec2 d = s.b - s.a;
+                s.length = glm::length(d);
+                if (s.length <= 1e-6f) continue;
+
+                glm::vec2 n(d.y, -d.x);
+                n /= s.length;
+                if (glm::dot(n, grad) > 0.0f) n = -n;
+
+                s.outward = n;
+                s.slope = slope;
+                totalLength += s.length;
+                segments.push_back(s);
+            }
+        }
+    }
+}
+
+void Coastline::DistanceBatch(const float* x, const float* z, int n, float* outDist) const
+{
+    for (int i = 0; i < n; i++)
+    {
+        glm::vec2 p(x[i], z[i]);
+        float best2 = 1e30f;
+        for (const CoastSegment& s : segments)
+        {
+            glm::vec2 ab = s.b - s.a;
+            float t = glm::clamp(glm::dot(p - s.a, ab) / (s.length * s.length), 0.0f, 1.0f);
+            glm::vec2 d = s.a + ab * t - p;
+            best2 = std::min(best2, glm::dot(d, d));
+        }
+        outDist[i] = segments.empty() ? 1e30f : std::sqrt(best2);
+    }
+}
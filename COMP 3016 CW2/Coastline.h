@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <glm/glm/glm.hpp>
+
+//  COASTLINE
+// The shoreline contour of an island heightfield, extracted once per island with marching
+// squares. Placement code queries it instead of rescanning the grid.
+
+struct CoastSegment
+{
+    glm::vec2 a{ 0.0f };            // island-local XZ end points on the contour
+    glm::vec2 b{ 0.0f };
+    glm::vec2 outward{ 0.0f };      // unit normal pointing from land to sea
+    float slope = 0.0f;             // height gradient across the shore (rise per unit)
+    float length = 0.0f;
+};
+
+class Coastline
+{
+public:
+    // Contour between samples above `level` (land) and the rest.
+    // heights is the row-major (gridSize + 1)^2 grid, centred on the island like Terrain::GridPoint.
+    // Cells are visited row by row, so segments come out in scan order, not chained.
+    void Extract(const float* heights, int gridSize, float spacing, float level);
+
+    const std::vector<CoastSegment>& Segments() const { return segments; }
+    bool Empty() const { return segments.empty(); }
+    float Length() const { return totalLength; }
+
+    // Distance from each of n points to the nearest segment, O(n * segments)
+    void DistanceBatch(const float* x, const float* z, int n, float* outDist) const;
+
+private:
+    std::vector<CoastSegment> segments;
+    float totalLength = 0.0f;
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstring>
+#include <GL/glew.h>
+#include <glm/glm/glm.hpp>
+
+//  FRAME UNIFORMS
+// Data every scene shader shares, as std140 uniform blocks written once per frame:
+//   FrameData - camera, sun, fog, time and waves
+//   SceneData - lighthouse lanterns, the beam and the sea level
+// The structs below mirror the GLSL declarations byte for byte (vec3s are padded out by the
+// float after them), so a change to either side has to be made to both. Shader binds the blocks
+// of every program to the binding points here by name, right after linking.
+
+constexpr GLuint kFrameDataBinding = 0;
+constexpr GLuint kSceneDataBinding = 1;
+
+// Size of uLanterns[] in the shaders
+constexpr int kMaxLanterns = 256;
+
+struct FrameData
+{
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::vec3 viewPos;     float time;
+    glm::vec3 lightDir;    float time01;       // lightDir: the way sunlight travels
+    glm::vec3 lightColor;  float fogEnabled;
+    glm::vec3 fogColor;    float fogDensity;
+    float waveStrength;    float waveSpeed;    float pad[2];
+};
+static_assert(sizeof(FrameData) == 208, "FrameData must match the std140 block");
+
+struct SceneData
+{
+    glm::vec4 lanterns[kMaxLanterns];          // xyz = position, w = intensity; picked by uLightIndex
+    glm::vec3 lanternColor;  float seaLevel;
+    glm::vec3 beamDir;       float beamInnerCos;
+    float beamOuterCos;      float beamRange;  glm::vec2 waterLightFade;   // fade start, end
+    float waterLightStrength;                  float pad[3];
+};
+static_assert(sizeof(SceneData) == 4160, "SceneData must match the std140 block");
+
+// Binding point for a block name, or GL_INVALID_INDEX if it is not one of the above
+inline GLuint UniformBlockBinding(const char* name)
+{
+    if (std::strcmp(name, "FrameData") == 0) return kFrameDataBinding;
+    if (std::strcmp(name, "SceneData") == 0) return kSceneDataBinding;
+    return GL_INVALID_INDEX;
+}
+
+// One uniform buffer holding a T, attached to a fixed binding point
+template<typename T>
+class UniformBuffer
+{
+public:
+    void Create(GLuint bindingPoint)
+    {
+        Destroy();
+        binding = bindingPoint;
+        glGenBuffers(1, &ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    // Rewrites the whole buffer and binds it
+    void Upload(const T& data)
+    {
+        if (!ubo) return;
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, ubo);
+    }
+
+    void Destroy()
+    {
+        if (ubo) glDeleteBuffers(1, &ubo);
+        ubo = 0;
+    }
+
+private:
+    GLuint ubo = 0;
+    GLuint binding = 0;
+};
@@ -0,0 +1,159 @@
+#include "Frustum.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FRUSTUM_SSE 1
+#include <xmmintrin.h>
+#endif
+
+void AabbList::Clear()
+{
+    cx.clear(); cy.clear(); cz.clear();
+    ex.clear(); ey.clear(); ez.clear();
+}
+
+void AabbList::Push(const Aabb& b)
+{
+    glm::vec3 c = b.Center(), e = b.Extent();
+    cx.push_back(c.x); cy.push_back(c.y); cz.push_back(c.z);
+    ex.push_back(e.x); ey.push_back(e.y); ez.push_back(e.z);
+}
+
+void SphereList::Resize(int n)
+{
+    cx.resize(n); cy.resize(n); cz.resize(n);
+    r.resize(n);
+}
+
+void SphereList::Set(int i, const glm::vec3& c, float radius)
+{
+    cx[i] = c.x; cy[i] = c.y; cz[i] = c.z;
+    r[i] = radius;
+}
+
+// Gribb / Hartmann: each plane is the last row of the matrix plus or minus one of the others
+void Frustum::Extract(const glm::mat4& m)
+{
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++)
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    planes[0] = row[3] + row[0];   // left
+    planes[1] = row[3] - row[0];   // right
+    planes[2] = row[3] + row[1];   // bottom
+    planes[3] = row[3] - row[1];   // top
+    planes[4] = row[3] + row[2];   // near
+    planes[5] = row[3] - row[2];   // far
+
+    for (int p = 0; p < 6; p++)
+    {
+        planes[p] /= glm::length(glm::vec3(planes[p]));
+        absNormals[p] = glm::abs(glm::vec3(planes[p]));
+    }
+}
+
+bool Frustum::Visible(const Aabb& b) const
+{
+    glm::vec3 c = b.Center(), e = b.Extent();
+    for (int p = 0; p < 6; p++)
+    {
+        if (glm::dot(glm::vec3(planes[p]), c) + planes[p].w + glm::dot(absNormals[p], e) < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::Visible(const glm::vec3& c, float radius) const
+{
+    for (int p = 0; p < 6; p++)
+    {
+        if (glm::dot(glm::vec3(planes[p]), c) + planes[p].w + radius < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+int Frustum::Cull(const AabbList& b, std::vector<uint8_t>& visible) const
+{
+    const int n = b.Size();
+    visible.resize(n);
+    int count = 0, i = 0;
+
+#ifdef FRUSTUM_SSE
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(&b.cx[i]), cy = _mm_loadu_ps(&b.cy[i]), cz = _mm_loadu_ps(&b.cz[i]);
+        __m128 ex = _mm_loadu_ps(&b.ex[i]), ey = _mm_loadu_ps(&b.ey[i]), ez = _mm_loadu_ps(&b.ez[i]);
+
+        // per plane: signed distance of the centre plus the box's reach towards the plane
+        __m128 outside = zero;
+        for (int p = 0; p < 6; p++)
+        {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), cx),
+                _mm_mul_ps(_mm_set1_ps(planes[p].y), cy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].z), cz), _mm_set1_ps(planes[p].w)));
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(absNormals[p].x), ex),
+                _mm_mul_ps(_mm_set1_ps(absNormals[p].y), ey)),
+                _mm_mul_ps(_mm_set1_ps(absNormals[p].z), ez));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), zero));
+        }
+
+        int mask = _mm_movemask_ps(outside);
+        for (int k = 0; k < 4; k++)
+        {
+            visible[i + k] = (uint8_t)!((mask >> k) & 1);
+            count += visible[i + k];
+        }
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        Aabb box;
+        glm::vec3 c(b.cx[i], b.cy[i], b.cz[i]), e(b.ex[i], b.ey[i], b.ez[i]);
+        box.min = c - e;
+        box.max = c + e;
+        visible[i] = (uint8_t)Visible(box);
+        count += visible[i];
+    }
+    return count;
+}
+
+int Frustum::Cull(const SphereList& s, std::vector<uint8_t>& visible) const
+{
+    const int n = s.Size();
+    visible.resize(n);
+    int count = 0, i = 0;
+
+#ifdef FRUSTUM_SSE
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(&s.cx[i]), cy = _mm_loadu_ps(&s.cy[i]), cz = _mm_loadu_ps(&s.cz[i]);
+        __m128 r = _mm_loadu_ps(&s.r[i]);
+
+        __m128 outside = zero;
+        for (int p = 0; p < 6; p++)
+        {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), cx),
+                _mm_mul_ps(_mm_set1_ps(planes[p].y), cy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].z), cz), _mm_set1_ps(planes[p].w)));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), zero));
+        }
+
+        int mask = _mm_movemask_ps(outside);
+        for (int k = 0; k < 4; k++)
+        {
+            visible[i + k] = (uint8_t)!((mask >> k) & 1);
+            count += visible[i + k];
+        }
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        visible[i] = (uint8_t)Visible(glm::vec3(s.cx[i], s.cy[i], s.cz[i]), s.r[i]);
+        count += visible[i];
+    }
+    return count;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm/glm.hpp>
+
+//  FRUSTUM CULLING
+// Bounding volumes and the view frustum test. The batch tests take volumes in columns (SoA) and
+// run four at a time with SSE where it is available. No GL, so generation can fill the bounds.
+
+struct Aabb
+{
+    glm::vec3 min{ 1e30f };
+    glm::vec3 max{ -1e30f };
+
+    bool Empty() const { return min.x > max.x; }
+    glm::vec3 Center() const { return (min + max) * 0.5f; }
+    glm::vec3 Extent() const { return (max - min) * 0.5f; }
+
+    void Add(const glm::vec3& p)
+    {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    void Add(const Aabb& b)
+    {
+        if (b.Empty()) return;
+        min = glm::min(min, b.min);
+        max = glm::max(max, b.max);
+    }
+
+    void AddSphere(const glm::vec3& c, float r)
+    {
+        Add(c - glm::vec3(r));
+        Add(c + glm::vec3(r));
+    }
+};
+
+// Box around b after the affine transform m (tight for b itself, loose only through rotation)
+inline Aabb TransformAabb(const Aabb& b, const glm::mat4& m)
+{
+    if (b.Empty()) return b;
+
+    glm::vec3 c = glm::vec3(m * glm::vec4(b.Center(), 1.0f));
+    glm::vec3 e = b.Extent();
+    glm::vec3 we(0.0f);
+    for (int j = 0; j < 3; j++)
+    {
+        we.x += std::fabs(m[j][0]) * e[j];
+        we.y += std::fabs(m[j][1]) * e[j];
+        we.z += std::fabs(m[j][2]) * e[j];
+    }
+
+    Aabb out;
+    out.min = c - we;
+    out.max = c + we;
+    return out;
+}
+
+// Boxes as centre / half-extent columns, the layout Frustum::Cull reads
+struct AabbList
+{
+    std::vector<float> cx, cy, cz, ex, ey, ez;
+
+    int Size() const { return (int)cx.size(); }
+    void Clear();
+    void Push(const Aabb& b);
+};
+
+struct SphereList
+{
+    std::vector<float> cx, cy, cz, r;
+
+    int Size() const { return (int)cx.size(); }
+    void Resize(int n);
+    void Set(int i, const glm::vec3& c, float radius);
+};
+
+class Frustum
+{
+public:
+    // Planes of proj * view, normalised and facing inwards
+    void Extract(const glm::mat4& viewProj);
+
+    bool Visible(const Aabb& b) const;
+    bool Visible(const glm::vec3& c, float radius) const;
+
+    // visible[i] = 0 when volume i is wholly outside a plane, else 1; returns the number visible.
+    // Conservative: a volume outside the frustum but not outside any one plane counts as visible.
+    int Cull(const AabbList& boxes, std::vector<uint8_t>& visible) const;
+    int Cull(const SphereList& spheres, std::vector<uint8_t>& visible) const;
+
+    // The six planes (left, right, bottom, top, near, far), e.g. for a shader
+    const glm::vec4* Planes() const { return planes; }
+
+private:
+    glm::vec4 planes[6];       // xyz = normal, w = distance; inside when dot(n, p) + w >= 0
+    glm::vec3 absNormals[6];
+};
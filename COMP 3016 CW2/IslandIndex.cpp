@@ -0,0 +1,149 @@
+#include "IslandIndex.h"
+#include <algorithm>
+#include <cmath>
+
+void IslandIndex::Build(const std::vector<glm::vec2>& points, const std::vector<int>& ids)
+{
+    entries.clear();
+    cellStart.clear();
+    cols = rows = 0;
+    if (points.empty()) return;
+
+    glm::vec2 lo(1e30f), hi(-1e30f);
+    for (const auto& p : points)
+    {
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+
+    // about one point per cell
+    glm::vec2 extent = glm::max(hi - lo, glm::vec2(1e-3f));
+    cellSize = std::sqrt(extent.x * extent.y / (float)points.size());
+    cellSize = std::max(cellSize, std::max(extent.x, extent.y) / 1024.0f);
+    origin = lo;
+    cols = std::min((int)(extent.x / cellSize) + 1, 1025);
+    rows = std::min((int)(extent.y / cellSize) + 1, 1025);
+
+    // counting sort by cell
+    std::vector<int> cellOf(points.size());
+    cellStart.assign((size_t)cols * rows + 1, 0);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        cellOf[i] = CellZ(points[i].y) * cols + CellX(points[i].x);
+        cellStart[cellOf[i] + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++)
+        cellStart[c] += cellStart[c - 1];
+
+    entries.resize(points.size());
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < points.size(); i++)
+        entries[fill[cellOf[i]]++] = { points[i], ids.empty() ? (int)i : ids[i] };
+}
+
+int IslandIndex::CellX(float x) const
+{
+    return glm::clamp((int)std::floor((x - origin.x) / cellSize), 0, cols - 1);
+}
+
+int IslandIndex::CellZ(float z) const
+{
+    return glm::clamp((int)std::floor((z - origin.y) / cellSize), 0, rows - 1);
+}
+
+void IslandIndex::Search(const glm::vec2& p, int k) const
+{
+    heap.clear();
+    if (entries.empty() || k <= 0) return;
+
+    auto visit = [&](int x, int z)
+        {
+            int c = z * cols + x;
+            for (int i = cellStart[c]; i < cellStart[c + 1]; i++)
+            {
+                glm::vec2 d = entries[i].p - p;
+                float d2 = glm::dot(d, d);
+                if ((int)heap.size() < k)
+                {
+                    heap.push_back({ d2, entries[i].id });
+                    std::push_heap(heap.begin(), heap.end());
+                }
+                else if (d2 < heap.front().first)
+                {
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.back() = { d2, entries[i].id };
+                    std::push_heap(heap.begin(), heap.end());
+                }
+            }
+        };
+
+    // Square rings of cells around the query cell, until nothing outside the visited box can
+    // beat the k-th best
+    const int cx = CellX(p.x), cz = CellZ(p.y);
+    for (int r = 0; ; r++)
+    {
+        for (int z = std::max(cz - r, 0); z <= std::min(cz + r, rows - 1); z++)
+        {
+            if (z == cz - r || z == cz + r)
+            {
+                for (int x = std::max(cx - r, 0); x <= std::min(cx + r, cols - 1); x++) visit(x, z);
+            }
+            else
+            {
+                if (cx - r >= 0) visit(cx - r, z);
+                if (cx + r < cols && r > 0) visit(cx + r, z);
+            }
+        }
+
+        // distance to the nearest side of the box that still has cells beyond it
+        const float inf = 1e30f;
+        float bound = inf;
+        if (cx - r > 0)        bound = std::min(bound, p.x - (origin.x + (cx - r) * cellSize));
+        if (cx + r < cols - 1) bound = std::min(bound, origin.x + (cx + r + 1) * cellSize - p.x);
+        if (cz - r > 0)        bound = std::min(bound, p.y - (origin.y + (cz - r) * cellSize));
+        if (cz + r < rows - 1) bound = std::min(bound, origin.y + (cz + r + 1) * cellSize - p.y);
+
+        if (bound >= inf) break;
+        if ((int)heap.size() == k && heap.front().first <= bound * bound) break;
+    }
+
+    std::sort_heap(heap.begin(), heap.end());
+}
+
+int IslandIndex::Nearest(const glm::vec2& p, float* outDist2) const
+{
+    Search(p, 1);
+    if (heap.empty()) return -1;
+
+    if (outDist2) *outDist2 = heap[0].first;
+    return heap[0].second;
+}
+
+void IslandIndex::KNearest(const glm::vec2& p, int k, std::vector<int>& out) const
+{
+    Search(p, k);
+    out.clear();
+    for (const auto& h : heap) out.push_back(h.second);
+}
+
+void IslandIndex::Radius(const glm::vec2& p, float radius, std::vector<int>& out) const
+{
+    out.clear();
+    if (entries.empty()) return;
+
+    const float r2 = radius * radius;
+    const int x0 = CellX(p.x - radius), x1 = CellX(p.x + radius);
+    const int z0 = CellZ(p.y - radius), z1 = CellZ(p.y + radius);
+
+    for (int z = z0; z <= z1; z++)
+    {
+        for (int c = z * cols + x0; c <= z * cols + x1; c++)
+        {
+            for (int i = cellStart[c]; i < cellStart[c + 1]; i++)
+            {
+                glm::vec2 d = entries[i].p - p;
+                if (glm::dot(d, d) <= r2) out.push_back(entries[i].id);
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <glm/glm/glm.hpp>
+
+//  ISLAND INDEX
+// Static 2D (XZ) point index for per-frame island lookups: a uniform grid sized from the point
+// count, with the ids of each cell stored contiguously. Queries only visit the cells around the
+// query point, so their cost does not grow with the size of the world.
+
+class IslandIndex
+{
+public:
+    // points[i] gets id ids[i] (or i when ids is empty). Rebuild whenever the points change.
+    void Build(const std::vector<glm::vec2>& points, const std::vector<int>& ids = {});
+
+    bool Empty() const { return entries.empty(); }
+    int Count() const { return (int)entries.size(); }
+
+    // Id of the closest point, -1 if empty; outDist2 gets its squared distance
+    int Nearest(const glm::vec2& p, float* outDist2 = nullptr) const;
+
+    // Up to k closest ids, nearest first
+    void KNearest(const glm::vec2& p, int k, std::vector<int>& out) const;
+
+    // Every id within radius of p (unordered)
+    void Radius(const glm::vec2& p, float radius, std::vector<int>& out) const;
+
+private:
+    struct Entry
+    {
+        glm::vec2 p;
+        int id;
+    };
+
+    glm::vec2 origin{ 0.0f };
+    float cellSize = 1.0f;
+    int cols = 0, rows = 0;
+    std::vector<int> cellStart;        // entries of cell c are [cellStart[c], cellStart[c + 1])
+    std::vector<Entry> entries;
+
+    // (squared distance, id) of the last search; a max-heap while searching, then sorted
+    mutable std::vector<std::pair<float, int>> heap;
+
+    void Search(const glm::vec2& p, int k) const;
+
+    int CellX(float x) const;
+    int CellZ(float z) const;
+};
@@ -0,0 +1,114 @@
+#include "JobPool.h"
+#include <algorithm>
+
+int JobPool::HardwareThreads()
+{
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 0 ? (int)n : 1;
+}
+
+JobPool::JobPool(int threadCount)
+{
+    if (threadCount <= 0) threadCount = HardwareThreads();
+
+    workers.reserve(threadCount);
+    for (int i = 0; i < threadCount; i++)
+        workers.emplace_back([this]() { WorkerLoop(); });
+}
+
+JobPool::~JobPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+
+    for (auto& t : workers)
+        if (t.joinable()) t.join();
+}
+
+void JobPool::Enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        queue.push_back(std::move(job));
+    }
+    cv.notify_one();
+}
+
+void JobPool::WorkerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]() { return stopping || !queue.empty(); });
+
+            // drain remaining work before exiting so no future is left unsatisfied
+            if (queue.empty()) return;
+
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+        job();
+    }
+}
+
+void JobPool::ParallelFor(int count, int grain, const std::function<void(int, int)>& body)
+{
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    const int chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || workers.empty())
+    {
+        body(0, count);
+        return;
+    }
+
+    // Shared with helper jobs that may only start after this call has returned
+    struct State
+    {
+        std::function<void(int, int)> body;
+        int count = 0, grain = 0, chunks = 0;
+        std::atomic<int> next{ 0 };
+        std::atomic<int> done{ 0 };
+        std::mutex m;
+        std::condition_variable cv;
+    };
+
+    auto st = std::make_shared<State>();
+    st->body = body;
+    st->count = count;
+    st->grain = grain;
+    st->chunks = chunks;
+
+    auto run = [st]()
+        {
+            for (;;)
+            {
+                int c = st->next.fetch_add(1);
+                if (c >= st->chunks) return;
+
+                int b = c * st->grain;
+                int e = std::min(b + st->grain, st->count);
+                st->body(b, e);
+
+                if (st->done.fetch_add(1) + 1 == st->chunks)
+                {
+                    std::lock_guard<std::mutex> lock(st->m);
+                    st->cv.notify_all();
+                }
+            }
+        };
+
+    int helpers = std::min((int)workers.size(), chunks - 1);
+    for (int i = 0; i < helpers; i++) Enqueue(run);
+
+    run();
+
+    std::unique_lock<std::mutex> lock(st->m);
+    st->cv.wait(lock, [&]() { return st->done.load() == st->chunks; });
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <atomic>
+
+// Small fixed-size worker pool for CPU-side world generation.
+// Jobs are plain callables; Submit hands back a future so callers can wait on a specific job.
+class JobPool
+{
+public:
+    // threadCount <= 0 picks std::thread::hardware_concurrency()
+    explicit JobPool(int threadCount = 0);
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    int ThreadCount() const { return (int)workers.size(); }
+
+    static int HardwareThreads();
+
+    template<typename Fn>
+    auto Submit(Fn fn) -> std::future<std::invoke_result_t<Fn>>;
+
+    // Runs body(begin, end) over [0, count) in chunks of `grain`. The calling thread works through
+    // chunks too and only waits for chunks already running elsewhere, so it is safe to call from
+    // inside a job on this pool.
+    void ParallelFor(int count, int grain, const std::function<void(int, int)>& body);
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+
+    void Enqueue(std::function<void()> job);
+    void WorkerLoop();
+};
+
+// Template implementation in header
+template<typename Fn>
+auto JobPool::Submit(Fn fn) -> std::future<std::invoke_result_t<Fn>>
+{
+    using R = std::invoke_result_t<Fn>;
+
+    // std::function needs a copyable target, so the task lives behind a shared_ptr
+    auto task = std::make_shared<std::packaged_task<R()>>(std::move(fn));
+    std::future<R> result = task->get_future();
+
+    Enqueue([task]() { (*task)(); });
+    return result;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm/glm.hpp>
+
+// Vertex layouts and the plain VAO/VBO/EBO handle shared by the renderer and world generation
+
+struct Vertex
+{
+    glm::vec3 pos;
+    glm::vec3 normal;
+    float moisture = 0.0f;
+    glm::vec2 uv;                
+};
+
+struct GLMesh
+{
+    GLuint vao = 0, vbo = 0, ebo = 0;
+    GLsizei indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+
+    void Destroy()
+    {
+        if (ebo) glDeleteBuffers(1, &ebo);
+        if (vbo) glDeleteBuffers(1, &vbo);
+        if (vao) glDeleteVertexArrays(1, &vao);
+        vao = vbo = ebo = 0;
+        indexCount = 0;
+    }
+
+    void Bind() const { glBindVertexArray(vao); }
+};
+
+struct ModelVertex
+{
+    glm::vec3 pos;
+    glm::vec3 normal;
+    glm::vec2 uv;
+};
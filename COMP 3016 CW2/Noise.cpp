@@ -0,0 +1,376 @@
+#include "Noise.h"
+#include <cmath>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NOISE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define NOISE_X86 0
+#endif
+
+// MSVC allows intrinsics for any instruction set; GCC/Clang need the target enabled per function
+#if NOISE_X86 && !defined(_MSC_VER)
+#define NOISE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NOISE_TARGET_SSE41
+#define NOISE_TARGET_AVX2
+#endif
+
+float hash2D(int x, int z, int seed)
+{
+    int h = x * 374761393 + z * 668265263 + seed * 1442695041;
+    h = (h ^ (h >> 13)) * 1274126177;
+    h ^= (h >> 16);
+    return (h & 0x00FFFFFF) / 16777215.0f;
+}
+
+static float smooth(float t) { return t * t * (3.0f - 2.0f * t); }
+static float lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+float valueNoise2D(float x, float z, int seed)
+{
+    int x0 = (int)floor(x);
+    int z0 = (int)floor(z);
+    int x1 = x0 + 1;
+    int z1 = z0 + 1;
+
+    float sx = smooth(x - x0);
+    float sz = smooth(z - z0);
+
+    float n00 = hash2D(x0, z0, seed);
+    float n10 = hash2D(x1, z0, seed);
+    float n01 = hash2D(x0, z1, seed);
+    float n11 = hash2D(x1, z1, seed);
+
+    return lerp(lerp(n00, n10, sx), lerp(n01, n11, sx), sz);
+}
+
+float fbm(float x, float z, int seed, int octaves, float lacunarity, float gain)
+{
+    float amp = 0.5f;
+    float freq = 1.0f;
+    float sum = 0.0f;
+
+    for (int i = 0; i < octaves; i++)
+    {
+        sum += amp * valueNoise2D(x * freq, z * freq, seed + i * 31);
+        freq *= lacunarity;
+        amp *= gain;
+    }
+    return sum;
+}
+
+const char* NoiseKernelName(NoiseKernel k)
+{
+    switch (k)
+    {
+    case NoiseKernel::Scalar: return "Scalar";
+    case NoiseKernel::SSE41: return "SSE4.1";
+    case NoiseKernel::AVX2: return "AVX2";
+    default: return "Unknown";
+    }
+}
+
+static void fbmScalar(const float* x, const float* z, int count, int seed, float* out,
+    int octaves, float lacunarity, float gain)
+{
+    for (int i = 0; i < count; i++)
+        out[i] = fbm(x[i], z[i], seed, octaves, lacunarity, gain);
+}
+
+#if NOISE_X86
+
+static NoiseKernel DetectKernel()
+{
+    bool sse41 = false;
+    bool avx2 = false;
+
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0);
+    int maxLeaf = r[0];
+
+    if (maxLeaf >= 1)
+    {
+        __cpuid(r, 1);
+        sse41 = (r[2] & (1 << 19)) != 0;
+
+        bool osxsave = (r[2] & (1 << 27)) != 0;
+        bool avx = (r[2] & (1 << 28)) != 0;
+        bool ymmEnabled = osxsave && ((_xgetbv(0) & 0x6) == 0x6);
+
+        if (avx && ymmEnabled && maxLeaf >= 7)
+        {
+            __cpuidex(r, 7, 0);
+            avx2 = (r[1] & (1 << 5)) != 0;
+        }
+    }
+#else
+    __builtin_cpu_init();
+    sse41 = __builtin_cpu_supports("sse4.1");
+    avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    if (avx2) return NoiseKernel::AVX2;
+    if (sse41) return NoiseKernel::SSE41;
+    return NoiseKernel::Scalar;
+}
+
+// Each kernel mirrors valueNoise2D/fbm operation for operation (same order, no FMA),
+// which is what keeps the results bit-identical to the scalar path.
+
+NOISE_TARGET_SSE41
+static __m128 hash4(__m128i x, __m128i z, __m128i seedTerm)
+{
+    __m128i h = _mm_add_epi32(
+        _mm_add_epi32(_mm_mullo_epi32(x, _mm_set1_epi32(374761393)),
+            _mm_mullo_epi32(z, _mm_set1_epi32(668265263))),
+        seedTerm);
+    h = _mm_mullo_epi32(_mm_xor_si128(h, _mm_srai_epi32(h, 13)), _mm_set1_epi32(1274126177));
+    h = _mm_xor_si128(h, _mm_srai_epi32(h, 16));
+    h = _mm_and_si128(h, _mm_set1_epi32(0x00FFFFFF));
+    return _mm_div_ps(_mm_cvtepi32_ps(h), _mm_set1_ps(16777215.0f));
+}
+
+NOISE_TARGET_SSE41
+static __m128 smooth4(__m128 t)
+{
+    __m128 k = _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), t));
+    return _mm_mul_ps(_mm_mul_ps(t, t), k);
+}
+
+NOISE_TARGET_SSE41
+static __m128 lerp4(__m128 a, __m128 b, __m128 t)
+{
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+NOISE_TARGET_SSE41
+static __m128 valueNoise4(__m128 x, __m128 z, int seed)
+{
+    __m128 fx = _mm_floor_ps(x);
+    __m128 fz = _mm_floor_ps(z);
+
+    __m128i x0 = _mm_cvttps_epi32(fx);
+    __m128i z0 = _mm_cvttps_epi32(fz);
+    __m128i one = _mm_set1_epi32(1);
+    __m128i x1 = _mm_add_epi32(x0, one);
+    __m128i z1 = _mm_add_epi32(z0, one);
+
+    __m128 sx = smooth4(_mm_sub_ps(x, fx));
+    __m128 sz = smooth4(_mm_sub_ps(z, fz));
+
+    __m128i seedTerm = _mm_set1_epi32(seed * 1442695041);
+    __m128 n00 = hash4(x0, z0, seedTerm);
+    __m128 n10 = hash4(x1, z0, seedTerm);
+    __m128 n01 = hash4(x0, z1, seedTerm);
+    __m128 n11 = hash4(x1, z1, seedTerm);
+
+    return lerp4(lerp4(n00, n10, sx), lerp4(n01, n11, sx), sz);
+}
+
+NOISE_TARGET_SSE41
+static void fbmSSE41(const float* x, const float* z, int count, int seed, float* out,
+    int octaves, float lacunarity, float gain)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 pz = _mm_loadu_ps(z + i);
+
+        float amp = 0.5f;
+        float freq = 1.0f;
+        __m128 sum = _mm_setzero_ps();
+
+        for (int o = 0; o < octaves; o++)
+        {
+            __m128 f = _mm_set1_ps(freq);
+            __m128 n = valueNoise4(_mm_mul_ps(px, f), _mm_mul_ps(pz, f), seed + o * 31);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(amp), n));
+            freq *= lacunarity;
+            amp *= gain;
+        }
+        _mm_storeu_ps(out + i, sum);
+    }
+
+    fbmScalar(x + i, z + i, count - i, seed, out + i, octaves, lacunarity, gain);
+}
+
+NOISE_TARGET_AVX2
+static __m256 hash8(__m256i x, __m256i z, __m256i seedTerm)
+{
+    __m256i h = _mm256_add_epi32(
+        _mm256_add_epi32(_mm256_mullo_epi32(x, _mm256_set1_epi32(374761393)),
+            _mm256_mullo_epi32(z, _mm256_set1_epi32(668265263))),
+        seedTerm);
+    h = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_srai_epi32(h, 13)), _mm256_set1_epi32(1274126177));
+    h = _mm256_xor_si256(h, _mm256_srai_epi32(h, 16));
+    h = _mm256_and_si256(h, _mm256_set1_epi32(0x00FFFFFF));
+    return _mm256_div_ps(_mm256_cvtepi32_ps(h), _mm256_set1_ps(16777215.0f));
+}
+
+NOISE_TARGET_AVX2
+static __m256 smooth8(__m256 t)
+{
+    __m256 k = _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), t));
+    return _mm256_mul_ps(_mm256_mul_ps(t, t), k);
+}
+
+NOISE_TARGET_AVX2
+static __m256 lerp8(__m256 a, __m256 b, __m256 t)
+{
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+NOISE_TARGET_AVX2
+static __m256 valueNoise8(__m256 x, __m256 z, int seed)
+{
+    __m256 fx = _mm256_floor_ps(x);
+    __m256 fz = _mm256_floor_ps(z);
+
+    __m256i x0 = _mm256_cvttps_epi32(fx);
+    __m256i z0 = _mm256_cvttps_epi32(fz);
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i x1 = _mm256_add_epi32(x0, one);
+    __m256i z1 = _mm256_add_epi32(z0, one);
+
+    __m256 sx = smooth8(_mm256_sub_ps(x, fx));
+    __m256 sz = smooth8(_mm256_sub_ps(z, fz));
+
+    __m256i seedTerm = _mm256_set1_epi32(seed * 1442695041);
+    __m256 n00 = hash8(x0, z0, seedTerm);
+    __m256 n10 = hash8(x1, z0, seedTerm);
+    __m256 n01 = hash8(x0, z1, seedTerm);
+    __m256 n11 = hash8(x1, z1, seedTerm);
+
+    return lerp8(lerp8(n00, n10, sx), lerp8(n01, n11, sx), sz);
+}
+
+NOISE_TARGET_AVX2
+static void fbmAVX2(const float* x, const float* z, int count, int seed, float* out,
+    int octaves, float lacunarity, float gain)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 pz = _mm256_loadu_ps(z + i);
+
+        float amp = 0.5f;
+        float freq = 1.0f;
+        __m256 sum = _mm256_setzero_ps();
+
+        for (int o = 0; o < octaves; o++)
+        {
+            __m256 f = _mm256_set1_ps(freq);
+            __m256 n = valueNoise8(_mm256_mul_ps(px, f), _mm256_mul_ps(pz, f), seed + o * 31);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(amp), n));
+            freq *= lacunarity;
+            amp *= gain;
+        }
+        _mm256_storeu_ps(out + i, sum);
+    }
+
+    // tail (< 8) goes through the 4-wide kernel, which handles its own scalar remainder
+    fbmSSE41(x + i, z + i, count - i, seed, out + i, octaves, lacunarity, gain);
+}
+
+#else
+
+static NoiseKernel DetectKernel() { return NoiseKernel::Scalar; }
+
+#endif
+
+NoiseKernel NoiseBestKernel()
+{
+    static const NoiseKernel best = DetectKernel();
+    return best;
+}
+
+void fbmBatchKernel(NoiseKernel kernel, const float* x, const float* z, int count, int seed, float* out,
+    int octaves, float lacunarity, float gain)
+{
+    if (count <= 0) return;
+    if ((int)kernel > (int)NoiseBestKernel()) kernel = NoiseBestKernel();
+
+#if NOISE_X86
+    if (kernel == NoiseKernel::AVX2)
+    {
+        fbmAVX2(x, z, count, seed, out, octaves, lacunarity, gain);
+        return;
+    }
+    if (kernel == NoiseKernel::SSE41)
+    {
+        fbmSSE41(x, z, count, seed, out, octaves, lacunarity, gain);
+        return;
+    }
+#endif
+
+    fbmScalar(x, z, count, seed, out, octaves, lacunarity, gain);
+}
+
+void fbmBatch(const float* x, const float* z, int count, int seed, float* out,
+    int octaves, float lacunarity, float gain)
+{
+    fbmBatchKernel(NoiseBestKernel(), x, z, count, seed, out, octaves, lacunarity, gain);
+}
+
+void LogNoiseKernelReport()
+{
+    // Same coordinate ranges Terrain::Build feeds in (world xz * 0.012 .. 0.16), plus negatives
+    const int N = 1 << 18;
+    std::vector<float> xs(N), zs(N), ref(N), got(N);
+
+    std::mt19937 rng(4242);
+    std::uniform_real_distribution<float> coord(-200.0f, 200.0f);
+    for (int i = 0; i < N; i++)
+    {
+        xs[i] = coord(rng);
+        zs[i] = coord(rng);
+    }
+
+    const int seed = 1337 + 1000;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; i++) ref[i] = fbm(xs[i], zs[i], seed);
+    auto t1 = std::chrono::steady_clock::now();
+
+    double scalarSec = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << "[Noise] fbm scalar: " << (scalarSec > 0.0 ? N / scalarSec / 1e6 : 0.0) << " Msamples/s\n";
+
+    for (int k = (int)NoiseKernel::SSE41; k <= (int)NoiseBestKernel(); k++)
+    {
+        NoiseKernel kernel = (NoiseKernel)k;
+
+        auto b0 = std::chrono::steady_clock::now();
+        fbmBatchKernel(kernel, xs.data(), zs.data(), N, seed, got.data());
+        auto b1 = std::chrono::steady_clock::now();
+
+        int mismatches = 0;
+        float maxDiff = 0.0f;
+        for (int i = 0; i < N; i++)
+        {
+            if (got[i] != ref[i]) mismatches++;
+            maxDiff = std::max(maxDiff, std::fabs(got[i] - ref[i]));
+        }
+
+        double sec = std::chrono::duration<double>(b1 - b0).count();
+        std::cout << "[Noise] fbm " << NoiseKernelName(kernel) << ": "
+            << (sec > 0.0 ? N / sec / 1e6 : 0.0) << " Msamples/s"
+            << " speedup=" << (sec > 0.0 ? scalarSec / sec : 0.0)
+            << " mismatches=" << mismatches << "/" << N
+            << " maxAbsDiff=" << maxDiff << "\n";
+    }
+
+    std::cout << "[Noise] active kernel: " << NoiseKernelName(NoiseBestKernel()) << "\n";
+}
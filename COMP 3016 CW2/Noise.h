@@ -0,0 +1,33 @@
+#pragma once
+
+//  NOISE
+// Value noise + fbm used by terrain generation.
+// The batched versions evaluate many points per call with SSE4.1 (4 wide) or AVX2 (8 wide)
+// when the CPU supports it, and give bit-identical results to the scalar functions.
+
+float hash2D(int x, int z, int seed);
+float valueNoise2D(float x, float z, int seed);
+float fbm(float x, float z, int seed, int octaves = 6, float lacunarity = 2.0f, float gain = 0.5f);
+
+enum class NoiseKernel : int
+{
+    Scalar = 0,
+    SSE41 = 1,
+    AVX2 = 2
+};
+
+const char* NoiseKernelName(NoiseKernel k);
+
+// Widest kernel this CPU supports (detected once)
+NoiseKernel NoiseBestKernel();
+
+// out[i] = fbm(x[i], z[i], seed, ...) for i in [0, count)
+void fbmBatch(const float* x, const float* z, int count, int seed, float* out,
+    int octaves = 6, float lacunarity = 2.0f, float gain = 0.5f);
+
+// Same as fbmBatch but pinned to one kernel (falls back to scalar if unsupported); for diagnostics
+void fbmBatchKernel(NoiseKernel kernel, const float* x, const float* z, int count, int seed, float* out,
+    int octaves = 6, float lacunarity = 2.0f, float gain = 0.5f);
+
+// Checks every supported kernel against scalar fbm and prints samples/sec for each
+void LogNoiseKernelReport();
@@ -1,7 +1,7 @@
 #include "RingSystem.h"
 #include "Shader.h"  
-
-class Camera { public: glm::vec3 pos; };
+#include <cmath>
+#include <functional>
 
                      static void BuildTorus(std::vector<RingVertex>& outV,
                          std::vector<unsigned int>& outI,
@@ -55,11 +55,40 @@ class Camera { public: glm::vec3 pos; };
                          }
                      }
 
+                     // Torus vertices (aPos, aNormal) and indices of `mesh` into the bound VAO
+                     static void SetMeshAttribs(const RingMesh& mesh)
+                     {
+                         glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+                         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+
+                         glEnableVertexAttribArray(0); // aPos
+                         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(RingVertex), (void*)offsetof(RingVertex, pos));
+
+                         glEnableVertexAttribArray(1); // aNormal
+                         glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(RingVertex), (void*)offsetof(RingVertex, normal));
+                     }
+
+                     // A RingSystem::Ring per element of the bound GL_ARRAY_BUFFER: position at `location`,
+                     // yaw / pitch / scale at location + 1
+                     static void SetRingAttribs(GLuint location, GLuint divisor)
+                     {
+                         using Ring = RingSystem::Ring;
+
+                         glEnableVertexAttribArray(location); // iPosWS
+                         glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(Ring), (void*)offsetof(Ring, posWS));
+                         glVertexAttribDivisor(location, divisor);
+
+                         glEnableVertexAttribArray(location + 1); // iYawPitchScale
+                         glVertexAttribPointer(location + 1, 3, GL_FLOAT, GL_FALSE, sizeof(Ring), (void*)offsetof(Ring, yaw));
+                         glVertexAttribDivisor(location + 1, divisor);
+                     }
+
                      void RingSystem::InitMesh(float majorR, float minorR, int segMajor, int segMinor)
                      {
                          std::vector<RingVertex> v;
                          std::vector<unsigned int> idx;
                          BuildTorus(v, idx, majorR, minorR, segMajor, segMinor);
+                         ringRadius = majorR + minorR;
 
                          mesh.Destroy();
 
@@ -75,115 +104,347 @@ class Camera { public: glm::vec3 pos; };
                          glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
                          glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizei)idx.size() * sizeof(unsigned int), idx.data(), GL_STATIC_DRAW);
 
-                         glEnableVertexAttribArray(0); // aPos
-                         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(RingVertex), (void*)offsetof(RingVertex, pos));
+                         SetMeshAttribs(mesh);
 
-                         glEnableVertexAttribArray(1); // aNormal
-                         glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(RingVertex), (void*)offsetof(RingVertex, normal));
+                         // Per-instance: the Ring records themselves
+                         glGenBuffers(1, &mesh.instanceVBO);
+                         glBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVBO);
+                         SetRingAttribs(2, 1);
+
+                         // Cull pass input: one point per ring
+                         glGenVertexArrays(1, &mesh.cullVAO);
+                         glBindVertexArray(mesh.cullVAO);
+                         glBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVBO);
+                         SetRingAttribs(0, 0);
+
+                         // The same mesh, instanced from the rings the cull pass kept
+                         glGenBuffers(1, &mesh.visibleVBO);
+                         glGenVertexArrays(1, &mesh.visibleVAO);
+                         glBindVertexArray(mesh.visibleVAO);
+                         SetMeshAttribs(mesh);
+                         glBindBuffer(GL_ARRAY_BUFFER, mesh.visibleVBO);
+                         SetRingAttribs(2, 1);
+
+                         glGenQueries(1, &mesh.cullQuery);
 
                          glBindVertexArray(0);
 
                          mesh.indexCount = (GLsizei)idx.size();
+                         instanceCapacity = 0;
+                         culled = false;
+                         MarkInstancesDirty(0);
                      }
 
                      void RingSystem::Destroy()
                      {
                          mesh.Destroy();
                          rings.clear();
+                         owners.clear();
+                         spawnIndices.clear();
+                         instanceCapacity = 0;
+                         culled = false;
                      }
 
                      void RingSystem::Reset()
                      {
                          rings.clear();
+                         owners.clear();
+                         spawnIndices.clear();
+                         gridDirty = true;
+                         MarkInstancesDirty(0);
                          score = 0;
                          collectedCount = 0;
                          totalCount = 0;
+                         spawnShortfall = 0;
                      }
 
-                     glm::mat4 RingSystem::RingModelMatrix(const Ring& r) const
+                     void RingSystem::TakeRings(RingSystem& other)
                      {
-                         glm::mat4 M(1.0f);
-                         M = glm::translate(M, r.posWS);
-                         M = glm::rotate(M, r.yaw, glm::vec3(0, 1, 0));
-                         M = glm::rotate(M, r.pitch, glm::vec3(1, 0, 0)); // NEW: tilt
-                         M = glm::scale(M, glm::vec3(r.scale));
-                         return M;
+                         rings = std::move(other.rings);
+                         owners = std::move(other.owners);
+                         owners.resize(rings.size(), 0);
+                         spawnIndices = std::move(other.spawnIndices);
+                         totalCount = (int)rings.size();
+                         spawnShortfall = other.spawnShortfall;
+                         score = 0;
+                         collectedCount = 0;
+                         gridDirty = true;
+                         MarkInstancesDirty(0);
+
+                         other.Reset();
                      }
 
+                     void RingSystem::AppendRings(RingSystem& other, int owner)
+                     {
+                         size_t first = rings.size();
+                         rings.insert(rings.end(), other.rings.begin(), other.rings.end());
+                         owners.resize(rings.size(), owner);
+                         spawnIndices.insert(spawnIndices.end(), other.spawnIndices.begin(), other.spawnIndices.end());
+                         totalCount += (int)(rings.size() - first);
+                         spawnShortfall += other.spawnShortfall;
+                         gridDirty = true;
+                         MarkInstancesDirty(first);
+
+                         other.Reset();
+                     }
 
-                     int RingSystem::UpdateCollect(const glm::vec3& playerPosWS)
+                     template<typename Pred>
+                     int RingSystem::RemoveWhere(Pred remove)
                      {
-                         int got = 0;
+                         // order-keeping compaction, so only the tail from the first removed ring is re-uploaded
+                         size_t keep = 0;
+                         size_t firstRemoved = rings.size();
+                         for (size_t i = 0; i < rings.size(); i++)
+                         {
+                             if (remove(i))
+                             {
+                                 firstRemoved = std::min(firstRemoved, i);
+                                 continue;
+                             }
+                             rings[keep] = rings[i];
+                             owners[keep] = owners[i];
+                             spawnIndices[keep] = spawnIndices[i];
+                             keep++;
+                         }
 
-                         float r2 = collectRadius * collectRadius;
+                         int removed = (int)(rings.size() - keep);
+                         if (removed == 0) return 0;
+
+                         rings.resize(keep);
+                         owners.resize(keep);
+                         spawnIndices.resize(keep);
+                         totalCount -= removed;
+                         gridDirty = true;
+                         MarkInstancesDirty(firstRemoved);
+                         return removed;
+                     }
 
-                         for (auto& ring : rings)
+                     int RingSystem::RemoveOwner(int owner)
+                     {
+                         return RemoveWhere([&](size_t i) { return owners[i] == owner; });
+                     }
+
+                     int RingSystem::RemoveSpawned(const std::vector<uint8_t>& gone)
+                     {
+                         return RemoveWhere([&](size_t i)
+                             {
+                                 size_t s = (size_t)spawnIndices[i];
+                                 return s < gone.size() && gone[s] != 0;
+                             });
+                     }
+
+                     void RingSystem::UploadInstances()
+                     {
+                         if (mesh.instanceVBO == 0 || instanceDirtyFrom >= rings.size())
                          {
-                             if (ring.collected) continue;
+                             instanceDirtyFrom = rings.size();
+                             return;
+                         }
 
-                             glm::vec3 d = playerPosWS - ring.posWS;
-                             float dist2 = glm::dot(d, d);
+                         glBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVBO);
+                         if (rings.size() > instanceCapacity)
+                         {
+                             instanceCapacity = rings.size();
+                             glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(Ring), rings.data(), GL_DYNAMIC_DRAW);
 
-                             if (dist2 <= r2)
+                             // the cull pass could keep every ring
+                             glBindBuffer(GL_ARRAY_BUFFER, mesh.visibleVBO);
+                             glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(Ring), nullptr, GL_DYNAMIC_COPY);
+                         }
+                         else
+                         {
+                             // collecting only rewrites the slots that swap-removes refilled
+                             glBufferSubData(GL_ARRAY_BUFFER, instanceDirtyFrom * sizeof(Ring),
+                                 (rings.size() - instanceDirtyFrom) * sizeof(Ring), rings.data() + instanceDirtyFrom);
+                         }
+                         glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+                         instanceDirtyFrom = rings.size();
+                         culled = false;
+                     }
+
+                     void RingSystem::BuildGrid()
+                     {
+                         gridDirty = false;
+                         gridCells.clear();
+                         gridRefs.resize(rings.size());
+                         if (rings.empty())
+                         {
+                             gridCols = gridRows = 0;
+                             return;
+                         }
+
+                         glm::vec2 lo(1e30f), hi(-1e30f);
+                         for (const auto& r : rings)
+                         {
+                             lo = glm::min(lo, glm::vec2(r.posWS.x, r.posWS.z));
+                             hi = glm::max(hi, glm::vec2(r.posWS.x, r.posWS.z));
+                         }
+
+                         // 16 m cells, coarser if the rings spread so far that the grid would pass 256 x 256
+                         glm::vec2 extent = hi - lo;
+                         gridCellSize = std::max(16.0f, std::max(extent.x, extent.y) / 256.0f);
+                         gridOrigin = lo;
+                         gridCols = (int)(extent.x / gridCellSize) + 1;
+                         gridRows = (int)(extent.y / gridCellSize) + 1;
+                         gridCells.resize((size_t)gridCols * (size_t)gridRows);
+
+                         for (int i = 0; i < (int)rings.size(); i++)
+                         {
+                             int cx = std::min((int)((rings[i].posWS.x - gridOrigin.x) / gridCellSize), gridCols - 1);
+                             int cz = std::min((int)((rings[i].posWS.z - gridOrigin.y) / gridCellSize), gridRows - 1);
+
+                             std::vector<int>& cell = gridCells[(size_t)cz * gridCols + cx];
+                             gridRefs[i].cell = cz * gridCols + cx;
+                             gridRefs[i].slot = (int)cell.size();
+                             cell.push_back(i);
+                         }
+                     }
+
+                     void RingSystem::RemoveRing(int i)
+                     {
+                         // out of its cell: the cell's last entry takes its slot
+                         std::vector<int>& cell = gridCells[gridRefs[i].cell];
+                         int moved = cell.back();
+                         cell[gridRefs[i].slot] = moved;
+                         gridRefs[moved].slot = gridRefs[i].slot;
+                         cell.pop_back();
+
+                         // out of the ring array: the last ring takes index i
+                         int last = (int)rings.size() - 1;
+                         MarkInstancesDirty(i);
+                         if (i != last)
+                         {
+                             rings[i] = rings[last];
+                             owners[i] = owners[last];
+                             spawnIndices[i] = spawnIndices[last];
+                             gridRefs[i] = gridRefs[last];
+                             gridCells[gridRefs[i].cell][gridRefs[i].slot] = i;
+                         }
+                         rings.pop_back();
+                         owners.pop_back();
+                         spawnIndices.pop_back();
+                         gridRefs.pop_back();
+                     }
+
+                     int RingSystem::UpdateCollect(const glm::vec3& fromWS, const glm::vec3& toWS)
+                     {
+                         lastCollected.clear();
+                         if (gridDirty) BuildGrid();
+                         if (rings.empty()) return 0;
+
+                         float r2 = collectRadius * collectRadius;
+
+                         glm::vec3 seg = toWS - fromWS;
+                         float segLen2 = glm::dot(seg, seg);
+
+                         // cells under the swept sphere's XZ bounds
+                         glm::vec2 lo = glm::min(glm::vec2(fromWS.x, fromWS.z), glm::vec2(toWS.x, toWS.z)) - collectRadius - gridOrigin;
+                         glm::vec2 hi = glm::max(glm::vec2(fromWS.x, fromWS.z), glm::vec2(toWS.x, toWS.z)) + collectRadius - gridOrigin;
+                         int x0 = std::max((int)std::floor(lo.x / gridCellSize), 0);
+                         int z0 = std::max((int)std::floor(lo.y / gridCellSize), 0);
+                         int x1 = std::min((int)std::floor(hi.x / gridCellSize), gridCols - 1);
+                         int z1 = std::min((int)std::floor(hi.y / gridCellSize), gridRows - 1);
+
+                         hits.clear();
+                         for (int cz = z0; cz <= z1; cz++)
+                         {
+                             for (int cx = x0; cx <= x1; cx++)
                              {
-                                 ring.collected = true;
-                                 got++;
-                                 collectedCount++;
-                                 score += pointsPerRing;
+                                 for (int i : gridCells[(size_t)cz * gridCols + cx])
+                                 {
+                                     // closest point of this frame's path to the ring
+                                     glm::vec3 d = rings[i].posWS - fromWS;
+                                     float t = segLen2 > 0.0f ? glm::clamp(glm::dot(d, seg) / segLen2, 0.0f, 1.0f) : 0.0f;
+                                     glm::vec3 off = d - seg * t;
+
+                                     if (glm::dot(off, off) <= r2) hits.push_back(i);
+                                 }
                              }
                          }
 
+                         // highest index first, so a swap-remove never moves a ring that is still to be removed
+                         std::sort(hits.begin(), hits.end(), std::greater<int>());
+                         for (int i : hits)
+                         {
+                             lastCollected.push_back({ owners[i], spawnIndices[i] });
+                             RemoveRing(i);
+                         }
+
+                         int got = (int)hits.size();
+                         collectedCount += got;
+                         score += got * pointsPerRing;
                          return got;
                      }
 
-                     void RingSystem::Draw(Shader& shader,
-                         const glm::mat4& view,
-                         const glm::mat4& proj,
-                         const Camera& cam,
-                         const glm::vec3& sunDir,
-                         const glm::vec3& sunCol,
-                         bool fogEnabled,
-                         const glm::vec3& fogColor,
-                         float fogDensity,
-                         float nightFactor)
+                     // Uniforms Draw sets, resolved once against the ring shader
+                     struct RingUniforms
                      {
-                         if (mesh.vao == 0 || mesh.indexCount == 0) return;
+                         Uniform<float> ambientStrength{ "uAmbientStrength" };
+                     };
 
-                         shader.Use();
+                     // Uniforms CullInstances sets on the ring cull program
+                     struct RingCullUniforms
+                     {
+                         Uniform<glm::vec4> frustumPlanes{ "uFrustumPlanes" };
+                         Uniform<float> ringRadius{ "uRingRadius" };
+                     };
 
-                         shader.SetMat4("uView", (float*)&view[0][0]);
-                         shader.SetMat4("uProj", (float*)&proj[0][0]);
+                     void RingSystem::CullInstances(Shader& cullShader, const Frustum& frustum)
+                     {
+                         UploadInstances();
+                         culled = false;
+                         if (rings.empty() || mesh.cullVAO == 0 || !cullShader.linkedOk) return;
 
-                         shader.SetVec3("uViewPos", cam.pos.x, cam.pos.y, cam.pos.z);
-                         shader.SetVec3("uLightDir", sunDir.x, sunDir.y, sunDir.z);
-                         shader.SetVec3("uLightColor", sunCol.x, sunCol.y, sunCol.z);
+                         static const RingCullUniforms u;
 
-                         // Make rings shiny / readable
-                         shader.SetFloat("uAmbientStrength", 0.35f);
-                         shader.SetFloat("uSpecStrength", 0.85f);
-                         shader.SetFloat("uShininess", 96.0f);
+                         cullShader.Use();
+                         cullShader.Set(u.frustumPlanes, frustum.Planes(), 6);
+                         cullShader.Set(u.ringRadius, ringRadius);
 
-                         shader.SetFloat("uFogEnabled", fogEnabled ? 1.0f : 0.0f);
-                         shader.SetVec3("uFogColor", fogColor.x, fogColor.y, fogColor.z);
-                         shader.SetFloat("uFogDensity", fogDensity);
+                         glEnable(GL_RASTERIZER_DISCARD);
+                         glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, mesh.visibleVBO);
+                         glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, mesh.cullQuery);
 
-                         // If your lighthouse shader expects these, keep them valid (but make lantern contribution 0)
-                         shader.SetFloat("uNightFactor", nightFactor);
-                         shader.SetVec3("uLanternPosWS", 0.0f, -99999.0f, 0.0f);
-                         shader.SetVec3("uLanternColor", 1.0f, 1.0f, 1.0f);
-                         shader.SetFloat("uLanternIntensity", 0.0f);
+                         glBeginTransformFeedback(GL_POINTS);
+                         glBindVertexArray(mesh.cullVAO);
+                         glDrawArrays(GL_POINTS, 0, (GLsizei)rings.size());
+                         glBindVertexArray(0);
+                         glEndTransformFeedback();
 
-                         glBindVertexArray(mesh.vao);
+                         glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+                         glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+                         glDisable(GL_RASTERIZER_DISCARD);
+                         culled = true;
+                     }
 
-                         for (const auto& ring : rings)
-                         {
-                             if (ring.collected) continue;
+                     int RingSystem::Draw(Shader& shader)
+                     {
+                         if (mesh.vao == 0 || mesh.indexCount == 0) return 0;
 
-                             glm::mat4 M = RingModelMatrix(ring);
-                             shader.SetMat4("uModel", (float*)&M[0][0]);
+                         static const RingUniforms u;
 
-                             glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0);
+                         shader.Use();
+
+                         // Make rings readable
+                         shader.Set(u.ambientStrength, 0.35f);
+
+                         UploadInstances();
+                         if (rings.empty()) return 0;
+
+                         // a cull result is used once; without a new one next frame, everything is drawn
+                         GLuint count = (GLuint)rings.size();
+                         GLuint vao = mesh.vao;
+                         if (culled)
+                         {
+                             glGetQueryObjectuiv(mesh.cullQuery, GL_QUERY_RESULT, &count);
+                             vao = mesh.visibleVAO;
+                             culled = false;
                          }
+                         if (count == 0) return 0;
 
+                         glBindVertexArray(vao);
+                         glDrawElementsInstanced(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0, (GLsizei)count);
                          glBindVertexArray(0);
+                         return (int)count;
                      }
@@ -1,14 +1,16 @@
 #pragma once
 #include <vector>
 #include <random>
+#include <algorithm>
+#include <cmath>
 #include <glm/glm/gtc/matrix_transform.hpp>
 #include <glm/glm/gtc/type_ptr.hpp>
 #include <glm/glm/gtc/constants.hpp>
 
 #include <GL/glew.h>
+#include "Frustum.h"
 
 class Shader;
-class Camera;
 
 // Minimal vertex for ring mesh (pos + normal)
 struct RingVertex
@@ -20,14 +22,27 @@ struct RingVertex
 struct RingMesh
 {
     GLuint vao = 0, vbo = 0, ebo = 0;
+    GLuint instanceVBO = 0;       // one RingSystem::Ring per live ring
     GLsizei indexCount = 0;
 
+    // Cull pass: instanceVBO as per-vertex input, the survivors captured into visibleVBO
+    GLuint cullVAO = 0;
+    GLuint visibleVAO = 0;        // mesh + visibleVBO as per-instance input
+    GLuint visibleVBO = 0;        // written by transform feedback, room for every live ring
+    GLuint cullQuery = 0;         // rings written to visibleVBO
+
     void Destroy()
     {
+        if (cullQuery) glDeleteQueries(1, &cullQuery);
+        if (visibleVBO) glDeleteBuffers(1, &visibleVBO);
+        if (visibleVAO) glDeleteVertexArrays(1, &visibleVAO);
+        if (cullVAO) glDeleteVertexArrays(1, &cullVAO);
+        if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
         if (ebo) glDeleteBuffers(1, &ebo);
         if (vbo) glDeleteBuffers(1, &vbo);
         if (vao) glDeleteVertexArrays(1, &vao);
-        vao = vbo = ebo = 0;
+        vao = vbo = ebo = instanceVBO = 0;
+        cullVAO = visibleVAO = visibleVBO = cullQuery = 0;
         indexCount = 0;
     }
 };
@@ -35,13 +50,13 @@ struct RingMesh
 class RingSystem
 {
 public:
+    // Also the per-instance vertex data of ring.vert (iPosWS, iYawPitchScale), uploaded as is
     struct Ring
     {
         glm::vec3 posWS{ 0.0f };
         float yaw = 0.0f;        // rotate around Y
         float pitch = 0.0f;      // rotate around X 
         float scale = 1.0f;
-        bool collected = false;
     };
 
     void InitMesh(float majorR = 2.0f, float minorR = 0.35f, int segMajor = 48, int segMinor = 18);
@@ -49,37 +64,66 @@ public:
 
     void Reset();
 
-    // Spawns rings around islands using terrain sampling callbacks (so RingSystem stays OOP/decoupled)
-    // sampleHeight(localX, localZ) should return local terrain height for that island
-    // sampleNormal(localX, localZ) should return local terrain normal for that island
-    template<typename HeightFn, typename NormalFn>
-    void SpawnForIsland(int islandIndex,
+    // Replaces the current rings with `other`'s (e.g. a set spawned off-thread) and resets scoring.
+    // Only ring data moves; this system keeps its own mesh.
+    void TakeRings(RingSystem& other);
+
+    // Streaming: adds `other`'s rings under an owner id, or drops every live ring of an owner.
+    // Scoring carries on; the total counts the rings that were ever live and not dropped.
+    void AppendRings(RingSystem& other, int owner);
+    int RemoveOwner(int owner);
+
+    // Drops the rings whose spawn index is flagged in `gone` (e.g. a streamed cell's rings that
+    // were collected on an earlier visit). Returns how many went.
+    int RemoveSpawned(const std::vector<uint8_t>& gone);
+
+    // Spawns rings around islands using a terrain sampling callback (so RingSystem stays OOP/decoupled)
+    // sample(localX, localZ, n, outHeight, outNormal, outShoreDist) should fill the local terrain
+    // height, normal and distance to the coastline of that island for n points at once.
+    // Rings are drawn from a fixed-size mask of spots in the island's ring band, so the cost is
+    // bounded; returns how many were placed (fewer than count if the band has too few valid spots).
+    template<typename SampleFn>
+    int SpawnForIsland(int islandIndex,
         const glm::vec2& islandCenterXZ,
         float islandHalfSize,
         int count,
         int seed,
-        HeightFn sampleHeight,
-        NormalFn sampleNormal);
-
-    // Returns how many rings were collected this frame
-    int UpdateCollect(const glm::vec3& playerPosWS);
-
-    void Draw(Shader& shader,
-        const glm::mat4& view,
-        const glm::mat4& proj,
-        const Camera& cam,
-        const glm::vec3& sunDir,
-        const glm::vec3& sunCol,
-        bool fogEnabled,
-        const glm::vec3& fogColor,
-        float fogDensity,
-        float nightFactor);
+        SampleFn sample);
+
+    // Collects every ring whose collect radius the player touched while moving from fromWS to
+    // toWS this frame (swept sphere, so fast movement cannot skip a ring).
+    // Returns how many rings were collected.
+    int UpdateCollect(const glm::vec3& fromWS, const glm::vec3& toWS);
+
+    // A ring the last UpdateCollect took: its owner and its position in the spawn order of the
+    // system that spawned it
+    struct CollectedRing
+    {
+        int owner = 0;
+        int spawnIndex = 0;
+    };
+    const std::vector<CollectedRing>& LastCollected() const { return lastCollected; }
+
+    // Runs every live ring through the ring cull program (ring_cull.vert/.geom) on the GPU; the
+    // next Draw then draws only the rings whose bounding sphere passes the frustum. The count is
+    // read back in Draw, so run this well before it.
+    void CullInstances(Shader& cullShader, const Frustum& frustum);
+
+    // Camera, sun and fog come from the FrameData block. Draws the rings the last CullInstances
+    // kept, or all of them if it has not run since the last Draw. Returns the number drawn.
+    int Draw(Shader& shader);
+
+    // Rings not collected yet; collected ones are removed (order is not kept)
+    const std::vector<Ring>& Rings() const { return rings; }
 
     // Scoring
     int GetScore() const { return score; }
     int GetCollected() const { return collectedCount; }
     int GetTotal() const { return totalCount; }
 
+    // Rings SpawnForIsland could not place for lack of valid spots, since the last Reset
+    int GetSpawnShortfall() const { return spawnShortfall; }
+
     // Tuning
     void SetCollectRadius(float r) { collectRadius = r; }
     void SetPointsPerRing(int p) { pointsPerRing = p; }
@@ -87,6 +131,37 @@ public:
 private:
     RingMesh mesh;
     std::vector<Ring> rings;
+    std::vector<int> owners;           // parallel to rings; 0 outside streamed worlds
+    std::vector<int> spawnIndices;     // parallel to rings; index when spawned, kept through moves
+    std::vector<CollectedRing> lastCollected;
+
+    // Instance buffer upkeep: rings [instanceDirtyFrom, end) changed since the last upload
+    size_t instanceCapacity = 0;
+    size_t instanceDirtyFrom = 0;
+    float ringRadius = 0.0f;           // of the torus at scale 1
+    bool culled = false;               // CullInstances has run since the last upload and Draw
+
+    // Uniform XZ grid over the live rings, rebuilt after rings are spawned or taken over.
+    // Each ring knows its cell and slot, so collecting one is two swap-removes.
+    struct GridRef
+    {
+        int cell = 0;
+        int slot = 0;
+    };
+    float gridCellSize = 16.0f;
+    glm::vec2 gridOrigin{ 0.0f };
+    int gridCols = 0, gridRows = 0;
+    std::vector<std::vector<int>> gridCells;
+    std::vector<GridRef> gridRefs;     // parallel to rings
+    bool gridDirty = true;
+    std::vector<int> hits;
+
+    void BuildGrid();
+    void RemoveRing(int i);
+
+    // Order-keeping compaction: drops every ring i for which remove(i) holds
+    template<typename Pred>
+    int RemoveWhere(Pred remove);
 
     float collectRadius = 2.25f;
     int pointsPerRing = 10;
@@ -94,56 +169,98 @@ private:
     int score = 0;
     int collectedCount = 0;
     int totalCount = 0;
+    int spawnShortfall = 0;
+
+    // Upper bound on the candidate spots sampled per island
+    static constexpr int kMaxMaskPoints = 1024;
 
-    glm::mat4 RingModelMatrix(const Ring& r) const;
+    void MarkInstancesDirty(size_t from)
+    {
+        instanceDirtyFrom = std::min(instanceDirtyFrom, from);
+        culled = false;
+    }
+    void UploadInstances();
 };
 
 // Template implementation in header
-template<typename HeightFn, typename NormalFn>
-void RingSystem::SpawnForIsland(int islandIndex,
+template<typename SampleFn>
+int RingSystem::SpawnForIsland(int islandIndex,
     const glm::vec2& islandCenterXZ,
     float islandHalfSize,
     int count,
     int seed,
-    HeightFn sampleHeight,
-    NormalFn sampleNormal)
+    SampleFn sample)
 {
     std::mt19937 rng(seed + islandIndex * 1337);
     std::uniform_real_distribution<float> u01(0.0f, 1.0f);
-    std::uniform_real_distribution<float> yawR(0.0f, 6.2831853f);
     std::uniform_real_distribution<float> scaleR(0.9f, 1.35f);
-    std::uniform_real_distribution<float> pitchR(glm::radians(65.0f), glm::radians(90.0f));
 
 
     // Place rings in a nice band around the island (avoid center and coastline)
     float rMin = islandHalfSize * 0.18f;
     float rMax = islandHalfSize * 0.62f;
+    if (count <= 0 || rMax <= rMin) return 0;
+
+    // Candidate mask: one jittered spot per cell of a lattice over the band, with the lattice
+    // sized so the band holds about kMaxMaskPoints of them. The mask is shuffled and then tested a
+    // batch at a time in that order, so the first `count` valid spots are a uniform pick of all
+    // valid ones, and the work stops there or once the mask runs out.
+    float area = glm::pi<float>() * (rMax * rMax - rMin * rMin);
+    float step = std::sqrt(area / (float)kMaxMaskPoints);
+    int side = (int)std::ceil(2.0f * rMax / step);
 
-    for (int i = 0; i < count; i++)
+    std::vector<glm::vec2> mask;
+    mask.reserve((size_t)side * side);
+    for (int j = 0; j < side; j++)
     {
-        // random polar
-        float a = u01(rng) * 6.2831853f;
-        float r = glm::mix(rMin, rMax, u01(rng));
+        for (int i = 0; i < side; i++)
+        {
+            glm::vec2 p(-rMax + (i + u01(rng)) * step, -rMax + (j + u01(rng)) * step);
+            float r2 = glm::dot(p, p);
+            if (r2 >= rMin * rMin && r2 <= rMax * rMax) mask.push_back(p);
+        }
+    }
+    std::shuffle(mask.begin(), mask.end(), rng);
+
+    const int batch = std::max(count * 4, 16);
+    std::vector<float> cx(batch), cz(batch), ch(batch), shore(batch);
+    std::vector<glm::vec3> cn(batch);
 
-        float lx = cos(a) * r;
-        float lz = sin(a) * r;
+    int placed = 0;
+    for (size_t next = 0; next < mask.size() && placed < count; next += batch)
+    {
+        int n = (int)std::min(mask.size() - next, (size_t)batch);
+        for (int k = 0; k < n; k++)
+        {
+            cx[k] = mask[next + k].x;
+            cz[k] = mask[next + k].y;
+        }
 
-        // Keep them on flatter ground
-        glm::vec3 n = sampleNormal(lx, lz);
-        if (n.y < 0.88f) { i--; continue; }
+        sample(cx.data(), cz.data(), n, ch.data(), cn.data(), shore.data());
 
-        float y = sampleHeight(lx, lz);
-        if (y < 0.0f) { i--; continue; }
+        for (int k = 0; k < n && placed < count; k++)
+        {
+            // Keep them on flatter ground
+            if (cn[k].y < 0.88f) continue;
+            if (ch[k] < 0.0f) continue;
+            if (shore[k] < 3.0f) continue;
 
-        Ring ring;
-        ring.posWS = glm::vec3(islandCenterXZ.x + lx, y + 5.0f + u01(rng) * 4.0f, islandCenterXZ.y + lz);
-        ring.yaw = a + glm::half_pi<float>();     
-        ring.pitch = glm::radians(85.0f);
-        ring.scale = scaleR(rng);
-        ring.collected = false;
+            Ring ring;
+            ring.posWS = glm::vec3(islandCenterXZ.x + cx[k], ch[k] + 5.0f + u01(rng) * 4.0f, islandCenterXZ.y + cz[k]);
+            ring.yaw = std::atan2(cz[k], cx[k]) + glm::half_pi<float>();
+            ring.pitch = glm::radians(85.0f);
+            ring.scale = scaleR(rng);
 
-        rings.push_back(ring);
+            rings.push_back(ring);
+            placed++;
+        }
     }
 
+    spawnShortfall += count - placed;
+    owners.resize(rings.size(), 0);
+    while (spawnIndices.size() < rings.size()) spawnIndices.push_back((int)spawnIndices.size());
     totalCount = (int)rings.size();
+    gridDirty = true;
+    MarkInstancesDirty(0);
+    return placed;
 }
@@ -0,0 +1,256 @@
+#include "Scatter.h"
+#include "Terrain.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm/gtc/constants.hpp>
+
+//  AliasTable
+
+void AliasTable::Build(const std::vector<float>& weights)
+{
+    const int n = (int)weights.size();
+    columns.clear();
+
+    total = 0.0f;
+    for (float w : weights) total += std::max(w, 0.0f);
+    if (n == 0 || total <= 0.0f) return;
+
+    std::vector<float> prob(n);
+    std::vector<int> alias(n);
+
+    // scaled so the average column is 1
+    std::vector<int> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    const float scale = (float)n / total;
+    for (int i = 0; i < n; i++)
+    {
+        prob[i] = std::max(weights[i], 0.0f) * scale;
+        alias[i] = i;
+        (prob[i] < 1.0f ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        int s = small.back(); small.pop_back();
+        int l = large.back();
+
+        alias[s] = l;
+        prob[l] -= 1.0f - prob[s];
+        if (prob[l] < 1.0f)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // leftovers are 1 up to rounding
+    for (int i : large) prob[i] = 1.0f;
+    for (int i : small) prob[i] = 1.0f;
+
+    columns.resize(n);
+    for (int i = 0; i < n; i++) columns[i] = { prob[i], alias[i] };
+}
+
+int AliasTable::Sample(std::mt19937& rng) const
+{
+    // one 32-bit draw: the high part picks the column, the remainder is the coin
+    uint64_t scaled = (uint64_t)rng() * (uint64_t)columns.size();
+    int i = (int)(scaled >> 32);
+    float coin = (float)(uint32_t)scaled * (1.0f / 4294967296.0f);
+    const Column& c = columns[i];
+    return coin < c.prob ? i : c.alias;
+}
+
+//  PoissonDiskGrid
+
+void PoissonDiskGrid::Init(const glm::vec2& minXZ, const glm::vec2& maxXZ, float minDist)
+{
+    origin = minXZ;
+    cellSize = std::max(minDist, 1e-4f) / std::sqrt(2.0f);
+    invCellSize = 1.0f / cellSize;
+    minDist2 = minDist * minDist;
+
+    glm::vec2 size = glm::max(maxXZ - minXZ, glm::vec2(0.0f));
+    cols = std::max(1, (int)std::ceil(size.x / cellSize));
+    rows = std::max(1, (int)std::ceil(size.y / cellSize));
+
+    cells.assign((size_t)cols * (size_t)rows, glm::vec2(kEmpty));
+}
+
+bool PoissonDiskGrid::IsFree(const glm::vec2& p) const
+{
+    int cx, cz;
+    return CellOf(p, cx, cz) && IsFree(p, cx, cz);
+}
+
+bool PoissonDiskGrid::TryInsert(const glm::vec2& p)
+{
+    int cx, cz;
+    if (!CellOf(p, cx, cz) || !IsFree(p, cx, cz)) return false;
+
+    cells[(size_t)cz * cols + cx] = p;
+    return true;
+}
+
+bool PoissonDiskGrid::CellOf(const glm::vec2& p, int& cx, int& cz) const
+{
+    if (p.x < origin.x || p.y < origin.y) return false;
+
+    cx = (int)((p.x - origin.x) * invCellSize);
+    cz = (int)((p.y - origin.y) * invCellSize);
+    return cx < cols && cz < rows;
+}
+
+bool PoissonDiskGrid::IsFree(const glm::vec2& p, int cx, int cz) const
+{
+    const int x0 = std::max(cx - 2, 0), x1 = std::min(cx + 2, cols - 1);
+    const int z0 = std::max(cz - 2, 0), z1 = std::min(cz + 2, rows - 1);
+
+    // empty cells hold a far-away point, so every cell is tested the same way
+    bool free = true;
+    for (int z = z0; z <= z1; z++)
+    {
+        const glm::vec2* row = &cells[(size_t)z * cols];
+        for (int x = x0; x <= x1; x++)
+        {
+            glm::vec2 d = row[x] - p;
+            free &= glm::dot(d, d) >= minDist2;
+        }
+    }
+    return free;
+}
+
+//  PropSpatialHash
+
+void PropSpatialHash::Init(float size, int expectedCount)
+{
+    cellSize = std::max(size, 1e-4f);
+    invCellSize = 1.0f / cellSize;
+    maxRadius = 0.0f;
+
+    entries.clear();
+    entries.reserve(std::max(expectedCount, 0));
+
+    size_t bucketCount = 64;
+    while (bucketCount < (size_t)expectedCount * 2) bucketCount *= 2;
+    buckets.assign(bucketCount, -1);
+}
+
+int PropSpatialHash::Bucket(int cx, int cz) const
+{
+    uint32_t h = (uint32_t)cx * 73856093u ^ (uint32_t)cz * 19349663u;
+    return (int)(h & (uint32_t)(buckets.size() - 1));
+}
+
+void PropSpatialHash::Rehash(size_t bucketCount)
+{
+    buckets.assign(bucketCount, -1);
+    for (int i = 0; i < (int)entries.size(); i++)
+    {
+        Entry& e = entries[i];
+        int b = Bucket((int)std::floor(e.p.x * invCellSize), (int)std::floor(e.p.y * invCellSize));
+        e.next = buckets[b];
+        buckets[b] = i;
+    }
+}
+
+void PropSpatialHash::Insert(const glm::vec2& p, float radius)
+{
+    // keep the load factor under 1/2
+    if (buckets.empty() || (entries.size() + 1) * 2 > buckets.size())
+        Rehash(std::max<size_t>(64, buckets.size() * 2));
+
+    int b = Bucket((int)std::floor(p.x * invCellSize), (int)std::floor(p.y * invCellSize));
+    entries.push_back({ p, radius, buckets[b] });
+    buckets[b] = (int)entries.size() - 1;
+    maxRadius = std::max(maxRadius, radius);
+}
+
+bool PropSpatialHash::Overlaps(const glm::vec2& p, float radius) const
+{
+    if (entries.empty()) return false;
+
+    // any disc that can touch this one has its centre within radius + maxRadius
+    float reach = radius + maxRadius;
+    int x0 = (int)std::floor((p.x - reach) * invCellSize);
+    int x1 = (int)std::floor((p.x + reach) * invCellSize);
+    int z0 = (int)std::floor((p.y - reach) * invCellSize);
+    int z1 = (int)std::floor((p.y + reach) * invCellSize);
+
+    for (int z = z0; z <= z1; z++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            // buckets are shared between cells; the distance test sorts out strays
+            for (int i = buckets[Bucket(x, z)]; i >= 0; i = entries[i].next)
+            {
+                const Entry& e = entries[i];
+                glm::vec2 d = e.p - p;
+                float r = e.radius + radius;
+                if (glm::dot(d, d) < r * r) return true;
+            }
+        }
+    }
+    return false;
+}
+
+//  PropScatter
+
+void PropScatter::Begin(const Terrain& t, float cellSize)
+{
+    terrain = &t;
+    occupied.Init(cellSize);
+}
+
+int PropScatter::Place(const PropType& type, int maxCount, int maxTries, std::mt19937& rng, std::vector<Placed>& out)
+{
+    if (!terrain || maxCount <= 0 || maxTries <= 0) return 0;
+
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+
+    const float half = terrain->HalfSize();
+    const float r0 = glm::clamp(type.minRadial01, 0.0f, 1.0f) * half;
+    const float r1 = glm::clamp(type.maxRadial01, 0.0f, 1.0f) * half;
+    if (r1 <= r0) return 0;
+
+    // squared radii, so the draw is uniform over the ring's area
+    const float r0Sq = r0 * r0;
+    const float r1Sq = r1 * r1;
+
+    const int chunk = 256;
+    cx.resize(chunk);
+    cz.resize(chunk);
+    ch.resize(chunk);
+    cn.resize(chunk);
+
+    int added = 0;
+    for (int tries = 0; tries < maxTries && added < maxCount; tries += chunk)
+    {
+        int count = std::min(chunk, maxTries - tries);
+        for (int k = 0; k < count; k++)
+        {
+            float a = u01(rng) * glm::two_pi<float>();
+            float r = std::sqrt(r0Sq + u01(rng) * (r1Sq - r0Sq));
+            cx[k] = std::cos(a) * r;
+            cz[k] = std::sin(a) * r;
+        }
+
+        terrain->SampleBatch(cx.data(), cz.data(), count, ch.data(), cn.data(), nullptr);
+
+        for (int k = 0; k < count && added < maxCount; k++)
+        {
+            if (cn[k].y < type.minNormalY) continue;
+            if (ch[k] < type.minHeight || ch[k] > type.maxHeight) continue;
+
+            glm::vec2 p(cx[k], cz[k]);
+            if (occupied.Overlaps(p, type.radius)) continue;
+            if (type.keepChance < 1.0f && u01(rng) > type.keepChance) continue;
+
+            occupied.Insert(p, type.radius);
+            out.push_back({ glm::vec3(cx[k], ch[k], cz[k]), cn[k] });
+            added++;
+        }
+    }
+    return added;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <glm/glm/glm.hpp>
+
+class Terrain;
+
+//  SCATTER
+// Building blocks for placing props: weighted sampling of grid samples, blue-noise
+// (Poisson-disk) spacing between accepted points, and a shared occupancy hash so props of
+// different types keep clear of each other.
+
+// Walker/Vose alias table: O(n) build, O(1) weighted draws of an index in [0, n).
+// Entries with weight <= 0 are never drawn.
+class AliasTable
+{
+public:
+    void Build(const std::vector<float>& weights);
+
+    bool Empty() const { return columns.empty(); }
+    float TotalWeight() const { return total; }
+
+    int Sample(std::mt19937& rng) const;
+
+private:
+    // Side by side so a draw touches one cache line
+    struct Column
+    {
+        float prob;                // chance of keeping this column, else alias
+        int alias;
+    };
+    std::vector<Column> columns;
+    float total = 0.0f;
+};
+
+// Minimum-distance test for points in a rectangle, backed by a uniform grid with cells of
+// minDist / sqrt(2): a cell holds at most one accepted point, so a test looks at 5 x 5 cells.
+// A test or insert touches only cells within 3 * minDist of its point, so threads may insert
+// concurrently into regions that far apart (e.g. alternate bands of rows).
+class PoissonDiskGrid
+{
+public:
+    void Init(const glm::vec2& minXZ, const glm::vec2& maxXZ, float minDist);
+
+    // True if p lies inside the rectangle and no accepted point is closer than minDist
+    bool IsFree(const glm::vec2& p) const;
+
+    // Accepts p if IsFree(p)
+    bool TryInsert(const glm::vec2& p);
+
+private:
+    static constexpr float kEmpty = 1e18f;
+
+    glm::vec2 origin{ 0.0f };
+    float cellSize = 1.0f;
+    float invCellSize = 1.0f;
+    float minDist2 = 0.0f;
+    int cols = 0, rows = 0;
+    std::vector<glm::vec2> cells;  // the accepted point in each cell, or kEmpty
+
+    bool CellOf(const glm::vec2& p, int& cx, int& cz) const;
+    bool IsFree(const glm::vec2& p, int cx, int cz) const;
+};
+
+// Occupied discs (centre + radius) in a hashed uniform grid. Unbounded in extent; a query looks
+// at the cells within radius + the largest inserted radius, so cost does not grow with count.
+class PropSpatialHash
+{
+public:
+    void Init(float cellSize, int expectedCount = 0);
+
+    void Insert(const glm::vec2& p, float radius);
+
+    // True if a disc of this radius at p touches any inserted disc
+    bool Overlaps(const glm::vec2& p, float radius) const;
+
+    int Count() const { return (int)entries.size(); }
+
+private:
+    struct Entry
+    {
+        glm::vec2 p;
+        float radius;
+        int next;                  // next entry in the same bucket, -1 = end
+    };
+
+    float cellSize = 1.0f;
+    float invCellSize = 1.0f;
+    float maxRadius = 0.0f;
+    std::vector<int> buckets;      // head entry per bucket, -1 = empty; size is a power of two
+    std::vector<Entry> entries;
+
+    int Bucket(int cx, int cz) const;
+    void Rehash(size_t bucketCount);
+};
+
+// Placement rules for one kind of prop, all in island-local units
+struct PropType
+{
+    float radius = 1.0f;           // footprint kept clear of every other prop
+    float minNormalY = 0.0f;       // slope limit (1 = flat only)
+    float minHeight = -1e9f;       // height band
+    float maxHeight = 1e9f;
+    float minRadial01 = 0.0f;      // band of distance from the island centre, / HalfSize
+    float maxRadial01 = 1.0f;
+    float keepChance = 1.0f;       // extra roll per valid spot, thins the layout out per seed
+};
+
+// Prop scatter for one island. Every prop placed (or reserved) goes into one PropSpatialHash, so
+// later types avoid earlier ones whatever their kind.
+class PropScatter
+{
+public:
+    struct Placed
+    {
+        glm::vec3 local;           // island-local position on the terrain
+        glm::vec3 normal;
+    };
+
+    void Begin(const Terrain& terrain, float cellSize);
+
+    // Marks an area as taken without placing anything (lighthouse, fixed props)
+    void Reserve(const glm::vec2& localXZ, float radius) { occupied.Insert(localXZ, radius); }
+
+    const PropSpatialHash& Occupied() const { return occupied; }
+
+    // Draws up to maxTries candidates uniformly over the type's radial band, evaluates them in
+    // batches against the terrain and accepts them in draw order, up to maxCount.
+    // Appends the accepted props to out and returns how many were added.
+    int Place(const PropType& type, int maxCount, int maxTries, std::mt19937& rng, std::vector<Placed>& out);
+
+private:
+    const Terrain* terrain = nullptr;
+    PropSpatialHash occupied;
+
+    std::vector<float> cx, cz, ch;
+    std::vector<glm::vec3> cn;
+};
@@ -1,7 +1,15 @@
 #include "Shader.h"
+#include "FrameUniforms.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    unsigned nextShaderSerial = 1;
+}
 
 std::string Shader::LoadFile(const std::string& path)
 {
@@ -40,6 +48,7 @@ GLuint Shader::Compile(GLenum type, const std::string& source)
 }
 
 Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
+    : serial(nextShaderSerial++)
 {
     std::string vertexCode = LoadFile(vertexPath);
     std::string fragmentCode = LoadFile(fragmentPath);
@@ -54,20 +63,46 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
 
     GLuint vertex = Compile(GL_VERTEX_SHADER, vertexCode);
     GLuint fragment = Compile(GL_FRAGMENT_SHADER, fragmentCode);
+    Link(vertex, fragment, {});
+}
+
+Shader::Shader(const std::string& vertexPath, const std::string& geometryPath, const std::vector<const char*>& feedbackVaryings)
+    : serial(nextShaderSerial++)
+{
+    std::string vertexCode = LoadFile(vertexPath);
+    std::string geometryCode = LoadFile(geometryPath);
+
+    if (vertexCode.empty() || geometryCode.empty())
+    {
+        std::cerr << "Shader source empty, aborting program creation.\n";
+        linkedOk = false;
+        ID = 0;
+        return;
+    }
+
+    GLuint vertex = Compile(GL_VERTEX_SHADER, vertexCode);
+    GLuint geometry = Compile(GL_GEOMETRY_SHADER, geometryCode);
+    Link(vertex, geometry, feedbackVaryings);
+}
 
-    if (vertex == 0 || fragment == 0)
+// Links the two compiled stages (either may be 0 after a failed compile) and deletes them
+void Shader::Link(GLuint first, GLuint second, const std::vector<const char*>& feedbackVaryings)
+{
+    if (first == 0 || second == 0)
     {
         linkedOk = false;
         ID = 0;
 
-        if (vertex) glDeleteShader(vertex);
-        if (fragment) glDeleteShader(fragment);
+        if (first) glDeleteShader(first);
+        if (second) glDeleteShader(second);
         return;
     }
 
     ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    glAttachShader(ID, first);
+    glAttachShader(ID, second);
+    if (!feedbackVaryings.empty())
+        glTransformFeedbackVaryings(ID, (GLsizei)feedbackVaryings.size(), feedbackVaryings.data(), GL_INTERLEAVED_ATTRIBS);
     glLinkProgram(ID);
 
     GLint success = 0;
@@ -85,10 +120,12 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
     else
     {
         linkedOk = true;
+        CacheUniforms();
+        BindUniformBlocks();
     }
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    glDeleteShader(first);
+    glDeleteShader(second);
 }
 
 Shader::~Shader()
@@ -102,34 +139,98 @@ void Shader::Use() const
     glUseProgram(ID);
 }
 
-void Shader::SetMat4(const std::string& name, const float* value) const
+// Every active uniform's location, read once after linking. Arrays are listed as "name[0]";
+// they are also stored under the bare name, which GL accepts for element 0.
+void Shader::CacheUniforms()
 {
-    if (!linkedOk || ID == 0) return;
-    GLint loc = glGetUniformLocation(ID, name.c_str());
+    uniforms.clear();
+
+    GLint count = 0, maxLen = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+
+    std::vector<char> buf(std::max(maxLen, 1));
+    for (GLint i = 0; i < count; i++)
+    {
+        GLsizei len = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, (GLuint)i, (GLsizei)buf.size(), &len, &size, &type, buf.data());
+
+        std::string name(buf.data(), len);
+        GLint loc = glGetUniformLocation(ID, name.c_str());
+        if (loc < 0) continue;   // block members
+
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            uniforms.push_back({ name.substr(0, name.size() - 3), loc });
+        uniforms.push_back({ std::move(name), loc });
+    }
+
+    std::sort(uniforms.begin(), uniforms.end());
+}
+
+// Points the program's uniform blocks at their binding points (FrameUniforms.h). Blocks a program
+// declares but never reads are not active, so only the ones in use show up here.
+void Shader::BindUniformBlocks()
+{
+    GLint count = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+
+    char name[64];
+    for (GLint i = 0; i < count; i++)
+    {
+        GLsizei len = 0;
+        glGetActiveUniformBlockName(ID, (GLuint)i, (GLsizei)sizeof(name), &len, name);
+
+        GLuint binding = UniformBlockBinding(name);
+        if (binding == GL_INVALID_INDEX)
+        {
+            std::cerr << "Shader: unknown uniform block " << name << "\n";
+            continue;
+        }
+        glUniformBlockBinding(ID, (GLuint)i, binding);
+    }
+}
+
+GLint Shader::Location(const char* name) const
+{
+    auto it = std::lower_bound(uniforms.begin(), uniforms.end(), name,
+        [](const std::pair<std::string, GLint>& u, const char* n) { return std::strcmp(u.first.c_str(), n) < 0; });
+    if (it == uniforms.end() || std::strcmp(it->first.c_str(), name) != 0) return -1;
+    return it->second;
+}
+
+void Shader::SetMat4(const char* name, const float* value) const
+{
+    GLint loc = Location(name);
     if (loc < 0) return;
     glUniformMatrix4fv(loc, 1, GL_FALSE, value);
 }
 
-void Shader::SetVec3(const std::string& name, float x, float y, float z) const
+void Shader::SetVec2(const char* name, float x, float y) const
+{
+    GLint loc = Location(name);
+    if (loc < 0) return;
+    glUniform2f(loc, x, y);
+}
+
+void Shader::SetVec3(const char* name, float x, float y, float z) const
 {
-    if (!linkedOk || ID == 0) return;
-    GLint loc = glGetUniformLocation(ID, name.c_str());
+    GLint loc = Location(name);
     if (loc < 0) return;
     glUniform3f(loc, x, y, z);
 }
 
-void Shader::SetFloat(const std::string& name, float v) const
+void Shader::SetFloat(const char* name, float v) const
 {
-    if (!linkedOk || ID == 0) return;
-    GLint loc = glGetUniformLocation(ID, name.c_str());
+    GLint loc = Location(name);
     if (loc < 0) return;
     glUniform1f(loc, v);
 }
 
-void Shader::SetInt(const std::string& name, int v) const
+void Shader::SetInt(const char* name, int v) const
 {
-    if (!linkedOk || ID == 0) return;
-    GLint loc = glGetUniformLocation(ID, name.c_str());
+    GLint loc = Location(name);
     if (loc < 0) return;
     glUniform1i(loc, v);
 }
@@ -1,6 +1,26 @@
 ﻿#pragma once
 #include <string>
+#include <vector>
+#include <utility>
 #include <GL/glew.h>
+#include <glm/glm/glm.hpp>
+
+// Handle to one uniform by name, resolved against a shader the first time it is set through it
+// (and again only if it is then used with a different shader). After that, setting it is a single
+// glUniform* call. Meant to be declared once, e.g. as a member or a static, not per frame.
+template<typename T>
+class Uniform
+{
+public:
+    explicit Uniform(const char* name) : name(name) {}
+    const char* Name() const { return name; }
+
+private:
+    friend class Shader;
+    const char* name;
+    mutable unsigned shaderSerial = 0;
+    mutable GLint location = -1;
+};
 
 class Shader
 {
@@ -9,16 +29,51 @@ public:
     bool linkedOk = false;
 
     Shader(const std::string& vertexPath, const std::string& fragmentPath);
+
+    // Transform feedback program: vertex and geometry stages, no fragment stage. The varyings are
+    // captured interleaved; "gl_NextBuffer" in the list moves on to the next buffer binding.
+    Shader(const std::string& vertexPath, const std::string& geometryPath, const std::vector<const char*>& feedbackVaryings);
     ~Shader();
 
     void Use() const;
 
-    void SetMat4(const std::string& name, const float* value) const;
-    void SetVec3(const std::string& name, float x, float y, float z) const;
-    void SetFloat(const std::string& name, float v) const;
-    void SetInt(const std::string& name, int v) const;   // ✅ add this
+    // Location of an active uniform from the table built at link time (-1 if not active).
+    // Binary search, no GL call or allocation.
+    GLint Location(const char* name) const;
+
+    // By name: a table lookup per call. Hot paths should use Uniform<T> handles instead.
+    void SetMat4(const char* name, const float* value) const;
+    void SetVec2(const char* name, float x, float y) const;
+    void SetVec3(const char* name, float x, float y, float z) const;
+    void SetFloat(const char* name, float v) const;
+    void SetInt(const char* name, int v) const;   // ✅ add this
+
+    void Set(const Uniform<glm::mat4>& u, const glm::mat4& v) const { GLint l = Resolve(u); if (l >= 0) glUniformMatrix4fv(l, 1, GL_FALSE, &v[0][0]); }
+    void Set(const Uniform<glm::vec2>& u, const glm::vec2& v) const { GLint l = Resolve(u); if (l >= 0) glUniform2f(l, v.x, v.y); }
+    void Set(const Uniform<glm::vec3>& u, const glm::vec3& v) const { GLint l = Resolve(u); if (l >= 0) glUniform3f(l, v.x, v.y, v.z); }
+    void Set(const Uniform<glm::vec4>& u, const glm::vec4& v) const { GLint l = Resolve(u); if (l >= 0) glUniform4f(l, v.x, v.y, v.z, v.w); }
+    void Set(const Uniform<glm::vec4>& u, const glm::vec4* v, int count) const { GLint l = Resolve(u); if (l >= 0) glUniform4fv(l, count, &v[0].x); }
+    void Set(const Uniform<float>& u, float v) const { GLint l = Resolve(u); if (l >= 0) glUniform1f(l, v); }
+    void Set(const Uniform<int>& u, int v) const { GLint l = Resolve(u); if (l >= 0) glUniform1i(l, v); }
 
 private:
+    unsigned serial = 0;                                  // unique per Shader, for Uniform<T> caching
+    std::vector<std::pair<std::string, GLint>> uniforms;  // active uniforms, sorted by name
+
     std::string LoadFile(const std::string& path);
     GLuint Compile(GLenum type, const std::string& source);
+    void Link(GLuint first, GLuint second, const std::vector<const char*>& feedbackVaryings);
+    void CacheUniforms();
+    void BindUniformBlocks();
+
+    template<typename T>
+    GLint Resolve(const Uniform<T>& u) const
+    {
+        if (u.shaderSerial != serial)
+        {
+            u.shaderSerial = serial;
+            u.location = Location(u.name);
+        }
+        return u.location;
+    }
 };
@@ -0,0 +1,548 @@
+#include "Terrain.h"
+#include "TerrainCache.h"
+#include "TerrainNormals.h"
+#include "JobPool.h"
+#include "Noise.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define TERRAIN_SAMPLE_SSE 1
+#include <emmintrin.h>
+#endif
+
+glm::vec3 Terrain::GridPoint(int i) const
+{
+    const int side = gridSize + 1;
+    float half = gridSize * spacing * 0.5f;
+    return glm::vec3((i % side) * spacing - half, heights[i], (i / side) * spacing - half);
+}
+
+glm::vec3 Terrain::NormalAt(int i) const
+{
+    const int side = gridSize + 1;
+    glm::vec3 n;
+    HeightfieldNormalAt(heights.data(), side, spacing, i % side, i / side, &n.x);
+    return n;
+}
+
+glm::vec3 Terrain::SampleNormalAtWorldXZ(float worldX, float worldZ) const
+{
+    return NormalAt(SampleIndex(worldX, worldZ));
+}
+
+float Terrain::SampleHeightAtWorldXZ(float worldX, float worldZ) const
+{
+    float half = gridSize * spacing * 0.5f;
+
+    float gx = (worldX + half) / spacing;
+    float gz = (worldZ + half) / spacing;
+
+    gx = glm::clamp(gx, 0.0f, (float)gridSize - 0.0001f);
+    gz = glm::clamp(gz, 0.0f, (float)gridSize - 0.0001f);
+
+    int x0 = (int)floor(gx);
+    int z0 = (int)floor(gz);
+
+    float tx = gx - x0;
+    float tz = gz - z0;
+
+    int row0 = z0 * (gridSize + 1);
+    int row1 = (z0 + 1) * (gridSize + 1);
+
+    float h00 = heights[row0 + x0];
+    float h10 = heights[row0 + (x0 + 1)];
+    float h01 = heights[row1 + x0];
+    float h11 = heights[row1 + (x0 + 1)];
+
+    float h = 0.0f;
+
+    if (tx + tz <= 1.0f)
+    {
+        float w00 = 1.0f - tx - tz;
+        float w01 = tz;
+        float w10 = tx;
+        h = w00 * h00 + w01 * h01 + w10 * h10;
+    }
+    else
+    {
+        float w11 = tx + tz - 1.0f;
+        float w10 = 1.0f - tz;
+        float w01 = 1.0f - tx;
+        h = w10 * h10 + w01 * h01 + w11 * h11;
+    }
+
+    return h;
+}
+
+float Terrain::SampleMoistureAtWorldXZ(float worldX, float worldZ) const
+{
+    return moisture[SampleIndex(worldX, worldZ)];
+}
+
+void Terrain::SampleBatch(const float* x, const float* z, int n,
+    float* outHeight, glm::vec3* outNormal, float* outMoisture) const
+{
+    if (outHeight) SampleHeightsBatch(x, z, n, outHeight);
+
+    if (outNormal || outMoisture)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            int idx = SampleIndex(x[i], z[i]);
+            if (outNormal) outNormal[i] = NormalAt(idx);
+            if (outMoisture) outMoisture[i] = moisture[idx];
+        }
+    }
+}
+
+// Same operations in the same order as SampleHeightAtWorldXZ, 4 points at a time: both triangle
+// interpolations are computed and the right one is picked per lane.
+void Terrain::SampleHeightsBatch(const float* x, const float* z, int n, float* out) const
+{
+    int i = 0;
+#ifdef TERRAIN_SAMPLE_SSE
+    const int side = gridSize + 1;
+    const float* h = heights.data();
+
+    const __m128 vHalf = _mm_set1_ps(gridSize * spacing * 0.5f);
+    const __m128 vSpacing = _mm_set1_ps(spacing);
+    const __m128 vMax = _mm_set1_ps((float)gridSize - 0.0001f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 gx = _mm_div_ps(_mm_add_ps(_mm_loadu_ps(x + i), vHalf), vSpacing);
+        __m128 gz = _mm_div_ps(_mm_add_ps(_mm_loadu_ps(z + i), vHalf), vSpacing);
+        gx = _mm_min_ps(_mm_max_ps(gx, zero), vMax);
+        gz = _mm_min_ps(_mm_max_ps(gz, zero), vMax);
+
+        // non-negative after the clamp, so truncation is floor
+        __m128i ix = _mm_cvttps_epi32(gx);
+        __m128i iz = _mm_cvttps_epi32(gz);
+        __m128 tx = _mm_sub_ps(gx, _mm_cvtepi32_ps(ix));
+        __m128 tz = _mm_sub_ps(gz, _mm_cvtepi32_ps(iz));
+
+        alignas(16) int xi[4], zi[4];
+        _mm_store_si128((__m128i*)xi, ix);
+        _mm_store_si128((__m128i*)zi, iz);
+
+        alignas(16) float h00[4], h10[4], h01[4], h11[4];
+        for (int k = 0; k < 4; k++)
+        {
+            const float* r0 = h + (size_t)zi[k] * side + xi[k];
+            const float* r1 = r0 + side;
+            h00[k] = r0[0];
+            h10[k] = r0[1];
+            h01[k] = r1[0];
+            h11[k] = r1[1];
+        }
+        __m128 v00 = _mm_load_ps(h00), v10 = _mm_load_ps(h10);
+        __m128 v01 = _mm_load_ps(h01), v11 = _mm_load_ps(h11);
+
+        __m128 sum = _mm_add_ps(tx, tz);
+
+        // lower triangle: (1 - tx - tz) * h00 + tz * h01 + tx * h10
+        __m128 w00 = _mm_sub_ps(_mm_sub_ps(one, tx), tz);
+        __m128 lower = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w00, v00), _mm_mul_ps(tz, v01)), _mm_mul_ps(tx, v10));
+
+        // upper triangle: (1 - tz) * h10 + (1 - tx) * h01 + (tx + tz - 1) * h11
+        __m128 w11 = _mm_sub_ps(sum, one);
+        __m128 upper = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, tz), v10), _mm_mul_ps(_mm_sub_ps(one, tx), v01)), _mm_mul_ps(w11, v11));
+
+        __m128 useLower = _mm_cmple_ps(sum, one);
+        _mm_storeu_ps(out + i, _mm_or_ps(_mm_and_ps(useLower, lower), _mm_andnot_ps(useLower, upper)));
+    }
+#endif
+    for (; i < n; i++)
+        out[i] = SampleHeightAtWorldXZ(x[i], z[i]);
+}
+
+void Terrain::Build(int gridSize, float spacing, int seed, IslandBiome islandBiome,
+    const TerrainCache* cache, JobPool* pool)
+{
+    this->gridSize = gridSize;
+    this->spacing = spacing;
+    this->seed = seed;
+
+    using Clock = std::chrono::steady_clock;
+    auto Ms = [](Clock::time_point a, Clock::time_point b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+    auto t0 = Clock::now();
+
+    float half = gridSize * spacing * 0.5f;
+
+    const size_t count = (size_t)(gridSize + 1) * (size_t)(gridSize + 1);
+    heights.clear();
+    moisture.clear();
+
+    TerrainCacheKey key;
+    key.seed = seed;
+    key.biome = (int)islandBiome;
+    key.gridSize = gridSize;
+    key.spacing = spacing;
+    key.seaLevel = seaLevel;
+    key.verticalMul = globalVerticalMul;
+
+    CachedHeightfield cached;
+    fromCache = cache && cache->Load(key, cached);
+
+    if (fromCache)
+    {
+        // Cache hit: no noise evaluation, samples come straight from the mapped file
+        heights.assign(cached.heights, cached.heights + count);
+        moisture.assign(cached.moisture, cached.moisture + count);
+    }
+    else
+    {
+        heights.reserve(count);
+        moisture.reserve(count);
+        GenerateHeights(half, islandBiome);
+
+        if (cache && cache->Enabled())
+            cache->Store(key, heights, moisture);
+    }
+
+    maxHeight = heights.empty() ? 0.0f : *std::max_element(heights.begin(), heights.end());
+
+    auto t1 = Clock::now();
+    PackTexels(pool);
+    auto t2 = Clock::now();
+    BuildLodTree();
+    auto t3 = Clock::now();
+    // Island shaping only eases the land down to sea level towards the rim, so the shoreline that
+    // shows above the water is taken a little higher
+    coast.Extract(heights.data(), gridSize, spacing, seaLevel + 0.10f);
+    auto t4 = Clock::now();
+
+    timings.heightsMs = Ms(t0, t1);
+    timings.normalsMs = Ms(t1, t2);
+    timings.lodMs = Ms(t2, t3);
+    timings.coastMs = Ms(t3, t4);
+}
+
+void Terrain::ComputeNormals(JobPool* pool, std::vector<glm::vec3>& out) const
+{
+    const int side = gridSize + 1;
+    out.resize(heights.size());
+
+    float* dst = &out[0].x;
+    const size_t stride = sizeof(glm::vec3) / sizeof(float);
+
+    if (pool)
+    {
+        pool->ParallelFor(side, 32, [&](int rowBegin, int rowEnd)
+            {
+                HeightfieldNormalsRows(heights.data(), side, spacing, rowBegin, rowEnd, dst, stride);
+            });
+    }
+    else
+    {
+        HeightfieldNormalsRows(heights.data(), side, spacing, 0, side, dst, stride);
+    }
+}
+
+void Terrain::ComputeNormalsScatter(std::vector<glm::vec3>& out) const
+{
+    out.assign(heights.size(), glm::vec3(0));
+
+    auto AddFace = [&](int ia, int ib, int ic)
+        {
+            glm::vec3 a = GridPoint(ia);
+            glm::vec3 b = GridPoint(ib);
+            glm::vec3 c = GridPoint(ic);
+            glm::vec3 n = glm::normalize(glm::cross(b - a, c - a));
+            out[ia] += n; out[ib] += n; out[ic] += n;
+        };
+
+    for (int z = 0; z < gridSize; z++)
+    {
+        for (int x = 0; x < gridSize; x++)
+        {
+            int i0 = z * (gridSize + 1) + x;
+            int i1 = (z + 1) * (gridSize + 1) + x;
+            AddFace(i0, i1, i0 + 1);
+            AddFace(i0 + 1, i1, i1 + 1);
+        }
+    }
+
+    for (auto& n : out) n = glm::normalize(n);
+}
+
+void Terrain::PackTexels(JobPool* pool)
+{
+    heightMin = 1e30f;
+    float heightMax = -1e30f;
+    for (float h : heights)
+    {
+        heightMin = std::min(heightMin, h);
+        heightMax = std::max(heightMax, h);
+    }
+    heightRange = std::max(heightMax - heightMin, 1e-4f);
+
+    std::vector<glm::vec3> normals;
+    ComputeNormals(pool, normals);
+
+    auto Unorm16 = [](float f) { return (uint16_t)(glm::clamp(f, 0.0f, 1.0f) * 65535.0f + 0.5f); };
+
+    texels.resize(heights.size() * 4);
+    for (size_t i = 0; i < heights.size(); i++)
+    {
+        float ou, ov;
+        OctEncodeNormal(normals[i].x, normals[i].y, normals[i].z, ou, ov);
+
+        uint16_t* t = &texels[i * 4];
+        t[0] = Unorm16((heights[i] - heightMin) / heightRange);
+        t[1] = Unorm16(ou * 0.5f + 0.5f);
+        t[2] = Unorm16(ov * 0.5f + 0.5f);
+        t[3] = Unorm16(moisture[i]);
+    }
+}
+
+void Terrain::BuildLodTree()
+{
+    lodLevels.clear();
+
+    int levelCount = 1;
+    while (lodLeafCells * (1 << (levelCount - 1)) < gridSize) levelCount++;
+    lodLevels.resize(levelCount);
+
+    // finest level straight from the grid
+    LodLevel& leaf = lodLevels[0];
+    leaf.nodeCells = lodLeafCells;
+    leaf.nodesPerSide = 1 << (levelCount - 1);
+    leaf.minMaxY.assign(leaf.nodesPerSide * leaf.nodesPerSide, glm::vec2(1e30f, -1e30f));
+
+    const int side = gridSize + 1;
+    for (int nz = 0; nz < leaf.nodesPerSide; nz++)
+    {
+        int z0 = nz * lodLeafCells;
+        if (z0 >= gridSize) continue;
+        int z1 = std::min(z0 + lodLeafCells, gridSize);
+
+        for (int nx = 0; nx < leaf.nodesPerSide; nx++)
+        {
+            int x0 = nx * lodLeafCells;
+            if (x0 >= gridSize) continue;
+            int x1 = std::min(x0 + lodLeafCells, gridSize);
+
+            glm::vec2& mm = leaf.minMaxY[nz * leaf.nodesPerSide + nx];
+            for (int z = z0; z <= z1; z++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    float y = heights[z * side + x];
+                    mm.x = std::min(mm.x, y);
+                    mm.y = std::max(mm.y, y);
+                }
+            }
+        }
+    }
+
+    for (int l = 1; l < levelCount; l++)
+    {
+        const LodLevel& child = lodLevels[l - 1];
+        LodLevel& level = lodLevels[l];
+        level.nodeCells = child.nodeCells * 2;
+        level.nodesPerSide = child.nodesPerSide / 2;
+        level.minMaxY.assign(level.nodesPerSide * level.nodesPerSide, glm::vec2(1e30f, -1e30f));
+
+        for (int nz = 0; nz < level.nodesPerSide; nz++)
+        {
+            for (int nx = 0; nx < level.nodesPerSide; nx++)
+            {
+                glm::vec2& mm = level.minMaxY[nz * level.nodesPerSide + nx];
+                for (int q = 0; q < 4; q++)
+                {
+                    int cx = nx * 2 + (q & 1);
+                    int cz = nz * 2 + (q >> 1);
+                    const glm::vec2& c = child.minMaxY[cz * child.nodesPerSide + cx];
+                    mm.x = std::min(mm.x, c.x);
+                    mm.y = std::max(mm.y, c.y);
+                }
+            }
+        }
+    }
+}
+
+bool Terrain::SelectLodNode(int level, int nx, int nz, const glm::vec3& camLocal, std::vector<LodDrawItem>& out) const
+{
+    const LodLevel& L = lodLevels[level];
+    const glm::vec2& mm = L.minMaxY[nz * L.nodesPerSide + nx];
+    if (mm.x > mm.y) return true;
+
+    float half = HalfSize();
+    float size = L.nodeCells * spacing;
+    glm::vec2 origin(nx * size - half, nz * size - half);
+    glm::vec3 bmin(origin.x, mm.x, origin.y);
+    glm::vec3 bmax(origin.x + size, mm.y, origin.y + size);
+
+    auto InRange = [&](float r)
+        {
+            glm::vec3 d = glm::max(glm::max(bmin - camLocal, camLocal - bmax), glm::vec3(0.0f));
+            return glm::dot(d, d) <= r * r;
+        };
+
+    if (!InRange(lodRanges[level])) return false;
+
+    if (level == 0 || !InRange(lodRanges[level - 1]))
+    {
+        out.push_back({ origin, size, level, -1 });
+        return true;
+    }
+
+    for (int q = 0; q < 4; q++)
+    {
+        int cx = nx * 2 + (q & 1);
+        int cz = nz * 2 + (q >> 1);
+        if (!SelectLodNode(level - 1, cx, cz, camLocal, out))
+            out.push_back({ origin, size, level, q });
+    }
+    return true;
+}
+
+void Terrain::GenerateHeights(float half, IslandBiome islandBiome)
+{
+    float globalHeightScale = 0.65f;
+    float heightMul = 1.0f;
+    float ridgeMul = 1.0f;
+    float moistureMul = 1.0f;
+    float baseLift = 0.0f;
+
+    switch (islandBiome)
+    {
+    case IslandBiome::Forest:
+        moistureMul = 1.25f;
+        break;
+    case IslandBiome::Grassland:
+        moistureMul = 1.05f;
+        heightMul = 0.95f;
+        break;
+    case IslandBiome::Snow:
+        heightMul = 1.35f;
+        ridgeMul = 1.25f;
+        moistureMul = 0.90f;
+        baseLift = 0.2f;
+        break;
+    case IslandBiome::Desert:
+        heightMul = 0.85f;
+        ridgeMul = 0.60f;
+        moistureMul = 0.40f;
+        break;
+    case IslandBiome::Village:
+        // Flatter terrain with moderate moisture (good for grass + town)
+        heightMul = 0.80f;
+        ridgeMul = 0.55f;
+        moistureMul = 0.95f;
+        baseLift = 0.10f;
+        break;
+    }
+
+    // Noise is evaluated a whole row at a time through the batched (SIMD) fbm;
+    // results are bit-identical to calling fbm() per vertex.
+    const int rowLen = gridSize + 1;
+    std::vector<float> rowWX(rowLen), nx(rowLen), nz(rowLen);
+    std::vector<float> rowBig(rowLen), rowMid(rowLen), rowSmall(rowLen), rowMoist(rowLen), rowMicro(rowLen);
+
+    for (int x = 0; x <= gridSize; x++)
+        rowWX[x] = x * spacing - half;
+
+    auto fbmRow = [&](float wz, float scale, int rowSeed, std::vector<float>& out)
+        {
+            for (int x = 0; x < rowLen; x++)
+            {
+                nx[x] = rowWX[x] * scale;
+                nz[x] = wz * scale;
+            }
+            fbmBatch(nx.data(), nz.data(), rowLen, rowSeed, out.data());
+        };
+
+    for (int z = 0; z <= gridSize; z++)
+    {
+        float rowWZ = z * spacing - half;
+
+        fbmRow(rowWZ, 0.012f, seed + 1000, rowBig);
+        fbmRow(rowWZ, 0.045f, seed + 2000, rowMid);
+        fbmRow(rowWZ, 0.160f, seed + 3000, rowSmall);
+        fbmRow(rowWZ, 0.035f, seed + 7777, rowMoist);
+        if (islandBiome == IslandBiome::Village)
+            fbmRow(rowWZ, 0.08f, seed + 4242, rowMicro);
+
+        for (int x = 0; x <= gridSize; x++)
+        {
+            float wx = rowWX[x];
+            float wz = rowWZ;
+
+            float ax = fabs(wx);
+            float az = fabs(wz);
+
+            float t = glm::clamp(glm::max(ax, az) / half, 0.0f, 1.0f);
+
+            float mask = 1.0f - glm::smoothstep(0.0f, 1.0f, t);
+            mask = pow(mask, 0.2f);
+
+            float nBig = rowBig[x] * 2.0f - 1.0f;
+            float nMid = rowMid[x] * 2.0f - 1.0f;
+            float nSmall = rowSmall[x] * 2.0f - 1.0f;
+
+            float ridge = 1.0f - fabs(nMid);
+            ridge = ridge * ridge;
+
+            float height =
+                (nBig * 5.0f * heightMul) +
+                (nMid * 3.5f * heightMul) +
+                (ridge * 4.5f * ridgeMul) +
+                (nSmall * 0.9f * heightMul);
+
+            height *= globalHeightScale * globalVerticalMul;
+            height += (4.2f + baseLift) * mask * globalVerticalMul;
+
+            float land = seaLevel + (height - seaLevel) * mask;
+
+            float coastStart = 0.05f;
+            float coast = glm::smoothstep(coastStart, 1.0f, t);
+            land = glm::mix(land, seaLevel, coast);
+
+            float rim = glm::smoothstep(0.88f, 1.0f, t);
+            land = glm::mix(land, seaLevel, rim);
+
+            float m = rowMoist[x];
+            float altitude01 = glm::clamp((land - seaLevel) / 10.0f, 0.0f, 1.0f);
+            m = glm::mix(m, m * 0.6f, altitude01);
+
+            m *= moistureMul;
+            m = glm::clamp(m, 0.0f, 1.0f);
+
+				// Village biome gets a flattened area in the center
+            if (islandBiome == IslandBiome::Village)
+            {
+                float r01 = glm::clamp(glm::length(glm::vec2(wx, wz)) / half, 0.0f, 1.0f);
+
+                float flatMask = 1.0f - glm::smoothstep(0.75f, 0.92f, r01);
+
+                float target = seaLevel + 2.2f;
+
+                // allow a tiny bit of variation
+                float micro = (rowMicro[x] - 0.5f) * 0.25f;
+
+                land = glm::mix(land, target + micro, flatMask * 0.95f);
+            }
+
+            heights.push_back(land);
+            moisture.push_back(m);
+        }
+    }
+}
+
+int Terrain::SampleIndex(float worldX, float worldZ) const
+{
+    float half = gridSize * spacing * 0.5f;
+    int gx = (int)floor((worldX + half) / spacing);
+    int gz = (int)floor((worldZ + half) / spacing);
+
+    gx = glm::clamp(gx, 0, gridSize);
+    gz = glm::clamp(gz, 0, gridSize);
+
+    return gz * (gridSize + 1) + gx;
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm/glm.hpp>
+#include "MeshTypes.h"
+#include "Coastline.h"
+
+class Shader;
+class TerrainCache;
+class JobPool;
+
+enum class IslandBiome : int
+{
+    Forest = 0,
+    Grassland = 1,
+    Snow = 2,
+    Desert = 3,
+    Village = 4
+};
+
+inline const char* IslandBiomeName(IslandBiome b)
+{
+    switch (b)
+    {
+    case IslandBiome::Forest: return "Forest";
+    case IslandBiome::Grassland: return "Grassland";
+    case IslandBiome::Snow: return "Snow";
+    case IslandBiome::Desert: return "Desert";
+    case IslandBiome::Village: return "Village";
+    default: return "Unknown";
+    }
+}
+
+//  Terrain LOD (CDLOD)
+
+// View-distance bands for the terrain quadtree. Level 0 (finest) is drawn within baseRange of the
+// camera, each coarser level covers twice the distance of the one below.
+struct TerrainLodSettings
+{
+    float baseRange = 14.0f;
+    float morphStartRatio = 0.7f; // fraction of a band after which vertices morph towards the next level
+};
+
+// One N x N grid patch shared by every terrain node of every island. There is no vertex buffer:
+// basic.vert turns gl_VertexID into grid coordinates (0..N) and places and displaces them from
+// the node and heightmap.
+// Indices are 16-bit triangle strips, one per patch row with a primitive restart between rows,
+// written quadrant by quadrant (x-low/z-low, x-high/z-low, x-low/z-high, x-high/z-high) so a node
+// can draw a single child quarter as one contiguous range. Quadrant rows are only N/2 + 1 vertices
+// long, so the previous row is still in the post-transform cache when the next one reuses it.
+struct TerrainPatchMesh
+{
+    static constexpr GLushort kRestartIndex = 0xFFFF;
+
+    GLMesh mesh;
+    int quads = 0;
+    GLsizei quarterIndexCount = 0;
+    int quarterTriangles = 0;
+
+    void Build(int n);
+    void Destroy();
+};
+
+//  Terrain
+
+// Recycles island heightmap textures between worlds, so regenerating is one glTexSubImage2D per
+// island instead of a fresh allocation. Textures are only handed out again for the same size.
+class TerrainTexturePool
+{
+public:
+    // A free texture of this size, or a new one
+    GLuint Acquire(int side);
+    void Release(GLuint tex, int side);
+    void Destroy();
+
+    int Created() const { return created; }
+    int Reused() const { return reused; }
+
+private:
+    struct Entry
+    {
+        GLuint tex = 0;
+        int side = 0;
+    };
+    std::vector<Entry> free;
+    int created = 0;
+    int reused = 0;
+};
+
+// One island heightfield. Build and the samplers are CPU only (Terrain.cpp); Upload, Draw and
+// Destroy are the GL side (TerrainGL.cpp), so generation can be linked without a GL context.
+class Terrain
+{
+public:
+    float seaLevel = 2.5f;
+    float globalVerticalMul = 3.0f;
+
+    // Grid cells covered by a finest-level LOD node (power of two)
+    int lodLeafCells = 8;
+
+    // Wall time of the stages of the last Build
+    struct BuildTimings
+    {
+        double heightsMs = 0.0;   // noise or cache load
+        double normalsMs = 0.0;   // normals + texel packing
+        double lodMs = 0.0;
+        double coastMs = 0.0;
+    };
+
+    float HalfSize() const { return gridSize * spacing * 0.5f; }
+
+    int GridSize() const { return gridSize; }
+    int SampleCount() const { return (int)heights.size(); }
+
+    // Row-major (gridSize + 1)^2 samples; the only per-sample data kept on the CPU
+    const std::vector<float>& Heights() const { return heights; }
+    const std::vector<float>& Moisture() const { return moisture; }
+
+    // Island-local position and normal of grid sample i
+    glm::vec3 GridPoint(int i) const;
+    glm::vec3 NormalAt(int i) const;
+    float MaxHeight() const { return maxHeight; }
+    float MinHeight() const { return heightMin; }
+    float Spacing() const { return spacing; }
+    bool FromCache() const { return fromCache; }
+    const BuildTimings& LastBuildTimings() const { return timings; }
+
+    // Shoreline contour (just above seaLevel), extracted by Build
+    const Coastline& Coast() const { return coast; }
+
+    glm::vec3 SampleNormalAtWorldXZ(float worldX, float worldZ) const;
+    float SampleHeightAtWorldXZ(float worldX, float worldZ) const;
+    float SampleMoistureAtWorldXZ(float worldX, float worldZ) const;
+
+    // The three samplers above for n island-local points (x[i], z[i]) in one call; pass nullptr
+    // for any output that is not needed. Results are bit-identical to the per-point samplers
+    // (heights are evaluated 4 at a time with SSE).
+    void SampleBatch(const float* x, const float* z, int n,
+        float* outHeight, glm::vec3* outNormal, float* outMoisture) const;
+
+    // CPU only (no GL calls), so islands can be built on worker threads; Upload() afterwards
+    // With a cache, a matching entry replaces all noise evaluation; misses are written back.
+    // With a pool, normal generation is split across its threads (safe from inside a pool job).
+    void Build(int gridSize, float spacing, int seed, IslandBiome islandBiome,
+        const TerrainCache* cache = nullptr, JobPool* pool = nullptr);
+
+    // Per-sample normals gathered from neighbouring grid heights, rows split across `pool`
+    void ComputeNormals(JobPool* pool, std::vector<glm::vec3>& out) const;
+
+    // Original path: face normals of the grid triangles scattered into their vertices.
+    // Kept as the reference for LogNormalsReport.
+    void ComputeNormalsScatter(std::vector<glm::vec3>& out) const;
+
+    // GL side of Build; must run on the thread that owns the context.
+    // The grid lives on the GPU as one RGBA16 texture (8 bytes per sample) that the shared patch
+    // mesh samples per node: r = height over [heightMin, heightMin + heightRange], gb = octahedral
+    // normal, a = moisture. With a pool the texture is recycled and only re-filled.
+    // The packed texels are released afterwards.
+    void Upload(TerrainTexturePool* texPool = nullptr);
+
+    // Bytes of terrain data this island keeps on the GPU
+    size_t GpuBytes() const
+    {
+        size_t texels = (size_t)(gridSize + 1) * (size_t)(gridSize + 1);
+        return texels * 4 * sizeof(uint16_t);
+    }
+
+    // Selects LOD nodes around the camera and draws them; returns the number of triangles submitted
+    int Draw(Shader& shader,
+        const TerrainPatchMesh& patch,
+        const TerrainLodSettings& lod,
+        const glm::mat4& model,
+        const glm::vec3& viewPos,
+        float islandBiomeId,
+        float islandSeed,
+        int lightIndex);
+
+    // Lighting constants shared by every island; once per frame, before the Draw calls
+    static void SetMaterial(Shader& shader);
+
+    int LodNodesDrawn() const { return (int)lodSelection.size(); }
+
+    // Releases the texture, back into texPool when given
+    void Destroy(TerrainTexturePool* texPool = nullptr);
+
+private:
+    int gridSize = 0;
+    float spacing = 0.0f;
+    int seed = 0;
+
+    std::vector<float> heights;
+    std::vector<float> moisture;
+    Coastline coast;
+
+    // RGBA16 texels packed by Build on the generating thread, consumed by Upload
+    std::vector<uint16_t> texels;
+
+    GLuint mapTex = 0;
+    float heightMin = 0.0f;
+    float heightRange = 1.0f;
+    float maxHeight = 0.0f;
+    bool fromCache = false;
+    BuildTimings timings;
+
+    // CDLOD quadtree: per level (0 = finest) the min/max height of every node.
+    // Nodes that fall entirely outside the grid have min > max and are never drawn.
+    struct LodLevel
+    {
+        int nodesPerSide = 0;
+        int nodeCells = 0;
+        std::vector<glm::vec2> minMaxY;
+    };
+
+    // A node drawn whole (quadrant < 0) or one quarter of it
+    struct LodDrawItem
+    {
+        glm::vec2 origin;
+        float size = 0.0f;
+        int level = 0;
+        int quadrant = -1;
+    };
+
+    std::vector<LodLevel> lodLevels;
+    std::vector<float> lodRanges;
+    std::vector<LodDrawItem> lodSelection;
+
+    // Height range, normals and the texel array for Upload
+    void PackTexels(JobPool* pool);
+
+    void BuildLodTree();
+
+    // CDLOD selection: returns false if the node is outside its level's range (the parent then
+    // covers that area itself). Children that fail are drawn as a quarter of this node.
+    bool SelectLodNode(int level, int nx, int nz, const glm::vec3& camLocal, std::vector<LodDrawItem>& out) const;
+
+    // Noise + island shaping for every grid vertex
+    void GenerateHeights(float half, IslandBiome islandBiome);
+
+    int SampleIndex(float worldX, float worldZ) const;
+
+    void SampleHeightsBatch(const float* x, const float* z, int n, float* out) const;
+};
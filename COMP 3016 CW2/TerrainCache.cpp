@@ -0,0 +1,346 @@
+#include "TerrainCache.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+//  MappedFile
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0)
+    {
+        CloseHandle(f);
+        return false;
+    }
+
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m)
+    {
+        CloseHandle(f);
+        return false;
+    }
+
+    void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(m);
+        CloseHandle(f);
+        return false;
+    }
+
+    fileHandle = f;
+    mapHandle = m;
+    data = (const unsigned char*)view;
+    size = (size_t)sz.QuadPart;
+#else
+    int f = open(path.c_str(), O_RDONLY);
+    if (f < 0) return false;
+
+    struct stat st;
+    if (fstat(f, &st) != 0 || st.st_size == 0)
+    {
+        close(f);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, f, 0);
+    if (view == MAP_FAILED)
+    {
+        close(f);
+        return false;
+    }
+
+    fd = f;
+    data = (const unsigned char*)view;
+    size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapHandle) CloseHandle((HANDLE)mapHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    mapHandle = fileHandle = nullptr;
+#else
+    if (data) munmap((void*)data, size);
+    if (fd >= 0) close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+//  TerrainCache
+
+namespace
+{
+    const uint32_t kMagic = 0x43464854; // "THFC"
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t seed;
+        int32_t biome;
+        int32_t gridSize;
+        float spacing;
+        float seaLevel;
+        float verticalMul;
+        uint32_t count;
+        uint32_t reserved;
+    };
+
+    std::string VersionPrefix()
+    {
+        return "v" + std::to_string(kTerrainGeneratorVersion) + "_";
+    }
+
+    bool SameBits(float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; }
+}
+
+void TerrainCache::Init(const std::string& directory, uint64_t maxBytes)
+{
+    dir = directory;
+    this->maxBytes = maxBytes;
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+    {
+        std::cerr << "Terrain cache disabled, cannot create " << dir << ": " << ec.message() << "\n";
+        dir.clear();
+        return;
+    }
+
+    struct Found
+    {
+        std::string path;
+        uint64_t bytes;
+        fs::file_time_type written;
+    };
+    std::vector<Found> found;
+
+    // Stale generator versions and half-written temp files go; current entries are indexed
+    int pruned = 0;
+    const std::string prefix = VersionPrefix();
+    for (const auto& entry : fs::directory_iterator(dir, ec))
+    {
+        if (!entry.is_regular_file(ec)) continue;
+
+        std::string name = entry.path().filename().string();
+        bool isEntry = entry.path().extension() == ".thf";
+        bool stale = entry.path().extension() == ".tmp" ||
+            (isEntry && name.compare(0, prefix.size(), prefix) != 0);
+
+        if (stale)
+        {
+            if (fs::remove(entry.path(), ec)) pruned++;
+        }
+        else if (isEntry)
+        {
+            std::error_code statEc;
+            Found f{ entry.path().string(), (uint64_t)entry.file_size(statEc), entry.last_write_time(statEc) };
+            if (!statEc) found.push_back(std::move(f));
+        }
+    }
+
+    // Oldest write first, so the last-use order carries over from the previous run
+    std::sort(found.begin(), found.end(),
+        [](const Found& a, const Found& b) { return a.written < b.written; });
+
+    std::lock_guard<std::mutex> lock(indexMutex);
+    index.clear();
+    byLastUse.clear();
+    indexedBytes = 0;
+    for (const Found& f : found) Record(f.path, f.bytes);
+
+    int overBudget = EvictOverBudget();
+
+    std::cout << "Terrain cache: " << dir << " (generator v" << kTerrainGeneratorVersion
+        << ", pruned " << pruned << " stale, " << overBudget << " over " << (maxBytes >> 20) << " MB budget)\n";
+}
+
+void TerrainCache::Record(const std::string& path, uint64_t bytes) const
+{
+    auto it = index.find(path);
+    if (it != index.end())
+    {
+        indexedBytes -= it->second.bytes;
+        byLastUse.erase(it->second.lastUse);
+    }
+    else
+    {
+        it = index.emplace(path, IndexEntry{}).first;
+    }
+
+    it->second.bytes = bytes;
+    it->second.lastUse = useClock++;
+    indexedBytes += bytes;
+    byLastUse.emplace(it->second.lastUse, path);
+}
+
+int TerrainCache::EvictOverBudget() const
+{
+    if (maxBytes == 0) return 0;
+
+    int evicted = 0;
+    std::error_code ec;
+    auto it = byLastUse.begin();
+    while (indexedBytes > maxBytes && it != byLastUse.end())
+    {
+        // A mapped entry can refuse deletion on Windows; it stays indexed and is tried again later
+        if (!fs::remove(it->second, ec) && ec)
+        {
+            ++it;
+            continue;
+        }
+
+        auto entry = index.find(it->second);
+        indexedBytes -= entry->second.bytes;
+        index.erase(entry);
+        it = byLastUse.erase(it);
+        evicted++;
+    }
+    return evicted;
+}
+
+std::string TerrainCache::PathFor(const TerrainCacheKey& key) const
+{
+    // Float parameters go into the name as raw bits so any tweak is a different entry
+    uint32_t bits[3];
+    std::memcpy(&bits[0], &key.spacing, 4);
+    std::memcpy(&bits[1], &key.seaLevel, 4);
+    std::memcpy(&bits[2], &key.verticalMul, 4);
+
+    std::ostringstream name;
+    name << VersionPrefix() << "s" << key.seed << "_b" << key.biome << "_g" << key.gridSize
+        << std::hex << "_" << bits[0] << "_" << bits[1] << "_" << bits[2] << ".thf";
+
+    return (fs::path(dir) / name.str()).string();
+}
+
+bool TerrainCache::Load(const TerrainCacheKey& key, CachedHeightfield& out) const
+{
+    if (!Enabled()) return false;
+
+    std::string path = PathFor(key);
+    if (!out.file.Open(path)) return false;
+
+    const size_t count = (size_t)(key.gridSize + 1) * (size_t)(key.gridSize + 1);
+    const size_t expected = sizeof(FileHeader) + count * 2 * sizeof(float);
+
+    FileHeader h;
+    bool ok = out.file.Size() == expected;
+    if (ok)
+    {
+        std::memcpy(&h, out.file.Data(), sizeof(h));
+        ok = h.magic == kMagic &&
+            h.version == kTerrainGeneratorVersion &&
+            h.seed == key.seed &&
+            h.biome == key.biome &&
+            h.gridSize == key.gridSize &&
+            SameBits(h.spacing, key.spacing) &&
+            SameBits(h.seaLevel, key.seaLevel) &&
+            SameBits(h.verticalMul, key.verticalMul) &&
+            h.count == (uint32_t)count;
+    }
+
+    if (!ok)
+    {
+        out.file.Close();
+        return false;
+    }
+
+    const float* payload = (const float*)(out.file.Data() + sizeof(FileHeader));
+    out.heights = payload;
+    out.moisture = payload + count;
+    out.count = count;
+
+    // A hit makes the entry the most recently used, here and (through its write time) next run
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+    std::lock_guard<std::mutex> lock(indexMutex);
+    Record(path, expected);
+    return true;
+}
+
+void TerrainCache::Store(const TerrainCacheKey& key, const std::vector<float>& heights, const std::vector<float>& moisture) const
+{
+    if (!Enabled() || heights.size() != moisture.size()) return;
+
+    FileHeader h{};
+    h.magic = kMagic;
+    h.version = kTerrainGeneratorVersion;
+    h.seed = key.seed;
+    h.biome = key.biome;
+    h.gridSize = key.gridSize;
+    h.spacing = key.spacing;
+    h.seaLevel = key.seaLevel;
+    h.verticalMul = key.verticalMul;
+    h.count = (uint32_t)heights.size();
+
+    // Write to a temp file and rename, so a reader never maps a half-written entry
+    std::string path = PathFor(key);
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f.is_open()) return;
+
+        f.write((const char*)&h, sizeof(h));
+        f.write((const char*)heights.data(), heights.size() * sizeof(float));
+        f.write((const char*)moisture.data(), moisture.size() * sizeof(float));
+        if (!f.good())
+        {
+            f.close();
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec)
+    {
+        fs::remove(tmp, ec);
+        return;
+    }
+
+    uint64_t bytes = sizeof(FileHeader) + (uint64_t)heights.size() * 2 * sizeof(float);
+
+    std::lock_guard<std::mutex> lock(indexMutex);
+    Record(path, bytes);
+    EvictOverBudget();
+}
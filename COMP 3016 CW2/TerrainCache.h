@@ -0,0 +1,100 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <map>
+#include <unordered_map>
+
+// Bump whenever Terrain::Build's noise or shaping changes; files from other versions are
+// never loaded and are deleted by TerrainCache::Init.
+constexpr uint32_t kTerrainGeneratorVersion = 1;
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+// Everything that changes the generated heightfield for one island
+struct TerrainCacheKey
+{
+    int seed = 0;
+    int biome = 0;
+    int gridSize = 0;
+    float spacing = 0.0f;
+    float seaLevel = 0.0f;
+    float verticalMul = 0.0f;
+};
+
+// A cache hit: heights and moisture point straight into the mapped file
+struct CachedHeightfield
+{
+    MappedFile file;
+    const float* heights = nullptr;
+    const float* moisture = nullptr;
+    size_t count = 0;
+};
+
+// Binary heightfield/moisture cache, one file per TerrainCacheKey.
+// Load and Store are safe to call from several generation workers at once (distinct keys).
+class TerrainCache
+{
+public:
+    // Creates the directory, removes entries written by other generator versions, indexes the
+    // rest and trims them to maxBytes (0 = unlimited), least recently used first
+    void Init(const std::string& directory, uint64_t maxBytes);
+
+    bool Enabled() const { return !dir.empty(); }
+
+    bool Load(const TerrainCacheKey& key, CachedHeightfield& out) const;
+    void Store(const TerrainCacheKey& key, const std::vector<float>& heights, const std::vector<float>& moisture) const;
+
+private:
+    std::string dir;
+    uint64_t maxBytes = 0;
+
+    // Size and last use of every entry, built once by Init and kept up to date by Load and
+    // Store, so the budget is enforced without scanning the directory. Last use is a sequence
+    // number; across runs it comes from the file write times, which a Load hit refreshes.
+    struct IndexEntry
+    {
+        uint64_t bytes = 0;
+        uint64_t lastUse = 0;
+    };
+    mutable std::mutex indexMutex;
+    mutable std::unordered_map<std::string, IndexEntry> index;   // by path
+    mutable std::map<uint64_t, std::string> byLastUse;           // oldest first
+    mutable uint64_t useClock = 0;
+    mutable uint64_t indexedBytes = 0;
+
+    std::string PathFor(const TerrainCacheKey& key) const;
+
+    // Both with indexMutex held. Record records (or refreshes) an entry as the most recently
+    // used; EvictOverBudget deletes the least recently used entries until the total fits maxBytes.
+    void Record(const std::string& path, uint64_t bytes) const;
+    int EvictOverBudget() const;
+};
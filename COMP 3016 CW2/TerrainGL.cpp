@@ -0,0 +1,236 @@
+#include "Terrain.h"
+#include "Shader.h"
+#include <algorithm>
+#include <cmath>
+
+// GL half of Terrain / TerrainPatchMesh; the world generation bench does not link this file
+
+namespace
+{
+    // Empty RGBA16 island map; filled with glTexSubImage2D
+    GLuint CreateTerrainMap(int side)
+    {
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16, side, side, 0, GL_RGBA, GL_UNSIGNED_SHORT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return tex;
+    }
+
+    // Uniforms Terrain sets, resolved once against the terrain shader; the rest come from the
+    // FrameData / SceneData blocks
+    struct TerrainUniforms
+    {
+        Uniform<glm::mat4> model{ "uModel" };
+        Uniform<float> ambientStrength{ "uAmbientStrength" };
+        Uniform<float> specStrength{ "uSpecStrength" };
+        Uniform<float> shininess{ "uShininess" };
+        Uniform<float> islandBiome{ "uIslandBiome" };
+        Uniform<float> islandSeed{ "uIslandSeed" };
+        Uniform<int> lightIndex{ "uLightIndex" };
+        Uniform<int> terrainMap{ "uTerrainMap" };
+        Uniform<glm::vec3> heightmapInfo{ "uHeightmapInfo" };
+        Uniform<glm::vec2> heightRange{ "uHeightRange" };
+        Uniform<float> patchQuads{ "uPatchQuads" };
+        Uniform<glm::vec2> nodeOrigin{ "uNodeOrigin" };
+        Uniform<float> nodeSize{ "uNodeSize" };
+        Uniform<glm::vec2> morphRange{ "uMorphRange" };
+    };
+
+    const TerrainUniforms& Uniforms()
+    {
+        static const TerrainUniforms u;
+        return u;
+    }
+}
+
+void TerrainPatchMesh::Build(int n)
+{
+    Destroy();
+    quads = n;
+
+    int h = n / 2;
+    std::vector<GLushort> idx;
+    idx.reserve(4 * h * (2 * (h + 1) + 1));
+    for (int q = 0; q < 4; q++)
+    {
+        int qx = (q & 1) * h;
+        int qz = (q >> 1) * h;
+        for (int z = qz; z < qz + h; z++)
+        {
+            // (z, x), (z + 1, x) pairs give the same winding as the old triangle list
+            for (int x = qx; x <= qx + h; x++)
+            {
+                idx.push_back((GLushort)(z * (n + 1) + x));
+                idx.push_back((GLushort)((z + 1) * (n + 1) + x));
+            }
+            idx.push_back(kRestartIndex);
+        }
+    }
+    quarterIndexCount = (GLsizei)(idx.size() / 4);
+    quarterTriangles = 2 * h * h;
+
+    glGenVertexArrays(1, &mesh.vao);
+    glGenBuffers(1, &mesh.ebo);
+
+    glBindVertexArray(mesh.vao);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx.size() * sizeof(GLushort), idx.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+
+    mesh.indexCount = (GLsizei)idx.size();
+    mesh.indexType = GL_UNSIGNED_SHORT;
+}
+
+void TerrainPatchMesh::Destroy()
+{
+    mesh.Destroy();
+    quads = 0;
+    quarterIndexCount = 0;
+    quarterTriangles = 0;
+}
+
+void Terrain::Upload(TerrainTexturePool* texPool)
+{
+    if (texels.empty()) return;
+
+    const int side = gridSize + 1;
+    if (!mapTex) mapTex = texPool ? texPool->Acquire(side) : CreateTerrainMap(side);
+
+    // 8-byte texels keep rows aligned for any size; the default alignment is fine
+    glBindTexture(GL_TEXTURE_2D, mapTex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, side, side, GL_RGBA, GL_UNSIGNED_SHORT, texels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::vector<uint16_t>().swap(texels);
+}
+
+void Terrain::SetMaterial(Shader& shader)
+{
+    const TerrainUniforms& u = Uniforms();
+
+    shader.Use();
+    shader.Set(u.ambientStrength, 0.20f);
+    shader.Set(u.specStrength, 0.35f);
+    shader.Set(u.shininess, 32.0f);
+
+    // island maps are bound to unit 4 by Draw
+    shader.Set(u.terrainMap, 4);
+}
+
+int Terrain::Draw(Shader& shader,
+    const TerrainPatchMesh& patch,
+    const TerrainLodSettings& lod,
+    const glm::mat4& model,
+    const glm::vec3& viewPos,
+    float islandBiomeId,
+    float islandSeed,
+    int lightIndex)
+{
+    if (!mapTex || patch.quads == 0 || lodLevels.empty()) return 0;
+
+    const TerrainUniforms& u = Uniforms();
+
+    shader.Use();
+    shader.Set(u.model, model);
+    shader.Set(u.islandBiome, islandBiomeId);
+    shader.Set(u.islandSeed, islandSeed);
+    shader.Set(u.lightIndex, lightIndex);
+
+    // band radius per level; the root level always covers the whole island
+    const int levelCount = (int)lodLevels.size();
+    lodRanges.resize(levelCount);
+    for (int l = 0; l < levelCount; l++)
+        lodRanges[l] = (l == levelCount - 1) ? 1e30f : lod.baseRange * (float)(1 << l);
+
+    glm::vec3 camLocal = glm::vec3(glm::inverse(model) * glm::vec4(viewPos, 1.0f));
+    lodSelection.clear();
+    SelectLodNode(levelCount - 1, 0, 0, camLocal, lodSelection);
+
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, mapTex);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.Set(u.heightmapInfo, glm::vec3(HalfSize(), 1.0f / spacing, 1.0f / (float)(gridSize + 1)));
+    shader.Set(u.heightRange, glm::vec2(heightMin, heightRange));
+    shader.Set(u.patchQuads, (float)patch.quads);
+
+    patch.mesh.Bind();
+    glEnable(GL_PRIMITIVE_RESTART);
+    glPrimitiveRestartIndex(TerrainPatchMesh::kRestartIndex);
+
+    int triangles = 0;
+    for (const LodDrawItem& item : lodSelection)
+    {
+        // vertices morph into the parent's grid over the last part of this level's band
+        float morphEnd = lodRanges[item.level];
+        float morphStart = 1e30f;
+        float morphInv = 0.0f;
+        if (item.level < levelCount - 1)
+        {
+            float prev = item.level > 0 ? lodRanges[item.level - 1] : 0.0f;
+            morphStart = prev + (morphEnd - prev) * lod.morphStartRatio;
+            morphInv = 1.0f / std::max(morphEnd - morphStart, 0.001f);
+        }
+
+        shader.Set(u.nodeOrigin, glm::vec2(item.origin.x, item.origin.y));
+        shader.Set(u.nodeSize, item.size);
+        shader.Set(u.morphRange, glm::vec2(morphStart, morphInv));
+
+        GLsizei count = item.quadrant < 0 ? patch.mesh.indexCount : patch.quarterIndexCount;
+        size_t first = item.quadrant < 0 ? 0 : (size_t)item.quadrant * (size_t)patch.quarterIndexCount;
+        glDrawElements(GL_TRIANGLE_STRIP, count, patch.mesh.indexType, (void*)(first * sizeof(GLushort)));
+        triangles += item.quadrant < 0 ? 4 * patch.quarterTriangles : patch.quarterTriangles;
+    }
+
+    // other meshes use 32-bit indices where 0xFFFF is a real vertex
+    glDisable(GL_PRIMITIVE_RESTART);
+    glBindVertexArray(0);
+    return triangles;
+}
+
+void Terrain::Destroy(TerrainTexturePool* texPool)
+{
+    if (mapTex)
+    {
+        if (texPool) texPool->Release(mapTex, gridSize + 1);
+        else glDeleteTextures(1, &mapTex);
+    }
+    mapTex = 0;
+}
+
+//  TerrainTexturePool
+
+GLuint TerrainTexturePool::Acquire(int side)
+{
+    for (size_t i = 0; i < free.size(); i++)
+    {
+        if (free[i].side != side) continue;
+
+        GLuint tex = free[i].tex;
+        free[i] = free.back();
+        free.pop_back();
+        reused++;
+        return tex;
+    }
+
+    created++;
+    return CreateTerrainMap(side);
+}
+
+void TerrainTexturePool::Release(GLuint tex, int side)
+{
+    if (tex) free.push_back({ tex, side });
+}
+
+void TerrainTexturePool::Destroy()
+{
+    for (const Entry& e : free) glDeleteTextures(1, &e.tex);
+    free.clear();
+}
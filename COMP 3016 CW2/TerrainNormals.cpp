@@ -0,0 +1,120 @@
+#include "TerrainNormals.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define TERRAIN_NORMALS_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // normalize(-gx, 1, -gz); the SSE path below does the same operations in the same order
+    inline void WriteNormal(float gx, float gz, float* n)
+    {
+        float inv = 1.0f / std::sqrt(gx * gx + 1.0f + gz * gz);
+        n[0] = -gx * inv;
+        n[1] = inv;
+        n[2] = -gz * inv;
+    }
+}
+
+void HeightfieldNormalsRows(const float* heights, int side, float spacing,
+    int rowBegin, int rowEnd, float* out, size_t stride)
+{
+    if (side < 2) return;
+
+    const float invCentral = 1.0f / (2.0f * spacing);
+    const float invEdge = 1.0f / spacing;
+
+    for (int z = rowBegin; z < rowEnd; z++)
+    {
+        const int zu = z > 0 ? z - 1 : z;
+        const int zd = z < side - 1 ? z + 1 : z;
+        const float invZ = (zd - zu) == 2 ? invCentral : invEdge;
+
+        const float* row = heights + (size_t)z * side;
+        const float* up = heights + (size_t)zu * side;
+        const float* down = heights + (size_t)zd * side;
+        float* o = out + (size_t)z * side * stride;
+
+        // left border
+        WriteNormal((row[1] - row[0]) * invEdge, (down[0] - up[0]) * invZ, o);
+
+        int x = 1;
+#ifdef TERRAIN_NORMALS_SSE
+        const __m128 vInvX = _mm_set1_ps(invCentral);
+        const __m128 vInvZ = _mm_set1_ps(invZ);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        for (; x + 4 <= side - 1; x += 4)
+        {
+            __m128 gx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + x + 1), _mm_loadu_ps(row + x - 1)), vInvX);
+            __m128 gz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(down + x), _mm_loadu_ps(up + x)), vInvZ);
+
+            __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, gx), one), _mm_mul_ps(gz, gz));
+            __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(len2));
+
+            alignas(16) float nx[4], ny[4], nz[4];
+            _mm_store_ps(nx, _mm_mul_ps(_mm_xor_ps(gx, signMask), inv));
+            _mm_store_ps(ny, inv);
+            _mm_store_ps(nz, _mm_mul_ps(_mm_xor_ps(gz, signMask), inv));
+
+            for (int k = 0; k < 4; k++)
+            {
+                float* n = o + (size_t)(x + k) * stride;
+                n[0] = nx[k];
+                n[1] = ny[k];
+                n[2] = nz[k];
+            }
+        }
+#endif
+        for (; x < side - 1; x++)
+            WriteNormal((row[x + 1] - row[x - 1]) * invCentral, (down[x] - up[x]) * invZ, o + (size_t)x * stride);
+
+        // right border
+        const int r = side - 1;
+        WriteNormal((row[r] - row[r - 1]) * invEdge, (down[r] - up[r]) * invZ, o + (size_t)r * stride);
+    }
+}
+
+void HeightfieldNormalAt(const float* heights, int side, float spacing, int x, int z, float* out)
+{
+    if (side < 2) return;
+
+    const int zu = z > 0 ? z - 1 : z;
+    const int zd = z < side - 1 ? z + 1 : z;
+    const int xl = x > 0 ? x - 1 : x;
+    const int xr = x < side - 1 ? x + 1 : x;
+
+    const float invX = (xr - xl) == 2 ? 1.0f / (2.0f * spacing) : 1.0f / spacing;
+    const float invZ = (zd - zu) == 2 ? 1.0f / (2.0f * spacing) : 1.0f / spacing;
+
+    const float* row = heights + (size_t)z * side;
+    WriteNormal((row[xr] - row[xl]) * invX, (heights[(size_t)zd * side + x] - heights[(size_t)zu * side + x]) * invZ, out);
+}
+
+void OctEncodeNormal(float x, float y, float z, float& u, float& v)
+{
+    float l1 = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if (l1 <= 0.0f)
+    {
+        u = v = 0.0f;
+        return;
+    }
+
+    float px = x / l1;
+    float pz = z / l1;
+
+    // lower hemisphere folds over the diagonals
+    if (y < 0.0f)
+    {
+        float fx = (1.0f - std::fabs(pz)) * (px >= 0.0f ? 1.0f : -1.0f);
+        float fz = (1.0f - std::fabs(px)) * (pz >= 0.0f ? 1.0f : -1.0f);
+        px = fx;
+        pz = fz;
+    }
+
+    u = px;
+    v = pz;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+
+//  TERRAIN NORMALS
+// Per-vertex normals of a regular heightfield gathered from neighbouring heights
+// (central differences, one-sided on the borders). Every vertex is independent, so rows can be
+// split across threads and the inner loop runs 4 vertices at a time with SSE.
+
+// Normals for rows [rowBegin, rowEnd) of a side x side grid with the given spacing.
+// heights is row-major; normal i is written to out[i * stride + 0..2].
+void HeightfieldNormalsRows(const float* heights, int side, float spacing,
+    int rowBegin, int rowEnd, float* out, size_t stride);
+
+// The same normal for the single vertex (x, z); bit-identical to what HeightfieldNormalsRows writes
+void HeightfieldNormalAt(const float* heights, int side, float spacing, int x, int z, float* out);
+
+// Octahedral encoding of a unit normal (y up) into u, v in [-1, 1]; decoded in basic.vert
+void OctEncodeNormal(float x, float y, float z, float& u, float& v);
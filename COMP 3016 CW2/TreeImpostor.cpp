@@ -0,0 +1,158 @@
+#include "TreeImpostor.h"
+#include "Shader.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <glm/glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    GLuint MakeAtlasTexture(int size)
+    {
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return tex;
+    }
+}
+
+glm::vec3 TreeImpostor::HemiOctDecode(const glm::vec2& e)
+{
+    glm::vec2 p = glm::vec2(e.x + e.y, e.x - e.y) * 0.5f;
+    return glm::normalize(glm::vec3(p.x, 1.0f - std::fabs(p.x) - std::fabs(p.y), p.y));
+}
+
+// Same as glm::lookAt's camera axes when looking along -dir
+void TreeImpostor::FrameBasis(const glm::vec3& dir, glm::vec3& right, glm::vec3& up)
+{
+    glm::vec3 upRef = std::fabs(dir.y) > 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    right = glm::normalize(glm::cross(upRef, dir));
+    up = glm::cross(dir, right);
+}
+
+bool TreeImpostor::Bake(const GLMesh& mesh, const Aabb& boundsMS, float treeMinY, float treeMaxY, float trunkFrac,
+    int frameCount, int frameSize)
+{
+    Destroy();
+    if (mesh.vao == 0 || boundsMS.Empty() || frameCount < 2 || frameSize < 8) return false;
+
+    Shader bake("shaders/impostor_bake.vert", "shaders/impostor_bake.frag");
+    if (!bake.linkedOk)
+    {
+        std::cerr << "Impostor bake shader failed; trees keep their meshes at range.\n";
+        return false;
+    }
+
+    const int size = frameCount * frameSize;
+    GLuint tex[2] = { MakeAtlasTexture(size), MakeAtlasTexture(size) };
+
+    GLuint fbo = 0, depth = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex[0], 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, tex[1], 0);
+
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+    const GLenum buffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, buffers);
+
+    bool ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (ok)
+    {
+        // empty texels get the leaf colour and an upward normal, so mip levels do not darken edges
+        const GLfloat clearAlbedo[4] = { 36.0f / 255.0f, 138.0f / 255.0f, 41.0f / 255.0f, 0.0f };
+        const GLfloat clearNormal[4] = { 0.5f, 1.0f, 0.5f, 0.0f };
+        glViewport(0, 0, size, size);
+        glClearBufferfv(GL_COLOR, 0, clearAlbedo);
+        glClearBufferfv(GL_COLOR, 1, clearNormal);
+        glClear(GL_DEPTH_BUFFER_BIT);
+
+        GLboolean wasCull = glIsEnabled(GL_CULL_FACE);
+        glDisable(GL_CULL_FACE);
+        glEnable(GL_DEPTH_TEST);
+
+        static const Uniform<glm::mat4> uViewProj("uViewProj");
+        static const Uniform<float> uTreeMinY("uTreeMinY");
+        static const Uniform<float> uTreeMaxY("uTreeMaxY");
+        static const Uniform<float> uTrunkFrac("uTrunkFrac");
+
+        bake.Use();
+        bake.Set(uTreeMinY, treeMinY);
+        bake.Set(uTreeMaxY, treeMaxY);
+        bake.Set(uTrunkFrac, trunkFrac);
+
+        const glm::vec3 c = boundsMS.Center();
+        const float r = glm::length(boundsMS.Extent());
+        const glm::mat4 proj = glm::ortho(-r, r, -r, r, 0.5f * r, 3.5f * r);
+
+        mesh.Bind();
+        for (int j = 0; j < frameCount; j++)
+        {
+            for (int i = 0; i < frameCount; i++)
+            {
+                glm::vec2 e = glm::vec2((float)i, (float)j) / (float)(frameCount - 1) * 2.0f - 1.0f;
+                glm::vec3 dir = HemiOctDecode(e);
+                glm::vec3 right, up;
+                FrameBasis(dir, right, up);
+
+                glViewport(i * frameSize, j * frameSize, frameSize, frameSize);
+                bake.Set(uViewProj, proj * glm::lookAt(c + dir * (2.0f * r), c, up));
+                glDrawElements(GL_TRIANGLES, mesh.indexCount, mesh.indexType, 0);
+            }
+        }
+        glBindVertexArray(0);
+
+        if (wasCull) glEnable(GL_CULL_FACE);
+
+        // mips stop while a frame is still a few texels wide, or frames would bleed together
+        int maxLevel = std::max((int)std::log2((float)frameSize) - 3, 0);
+        for (GLuint t : tex)
+        {
+            glBindTexture(GL_TEXTURE_2D, t);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        sphere = glm::vec4(c, r);
+        frames = frameCount;
+    }
+    else
+    {
+        std::cerr << "Impostor framebuffer incomplete; trees keep their meshes at range.\n";
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteRenderbuffers(1, &depth);
+    glDeleteFramebuffers(1, &fbo);
+
+    if (!ok)
+    {
+        glDeleteTextures(2, tex);
+        return false;
+    }
+
+    albedoTex = tex[0];
+    normalTex = tex[1];
+    std::cout << "Tree impostor: " << frameCount << "x" << frameCount << " frames of "
+        << frameSize << "px (" << size << "px atlas)\n";
+    return true;
+}
+
+void TreeImpostor::Destroy()
+{
+    if (albedoTex) glDeleteTextures(1, &albedoTex);
+    if (normalTex) glDeleteTextures(1, &normalTex);
+    albedoTex = normalTex = 0;
+    frames = 0;
+}
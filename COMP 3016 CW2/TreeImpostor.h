@@ -0,0 +1,41 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm/glm.hpp>
+#include "MeshTypes.h"
+#include "Frustum.h"
+
+//  TREE IMPOSTOR
+// The tree mesh baked into a hemi-octahedral atlas: frames x frames views from directions spread
+// over the upper hemisphere, each an orthographic shot of the mesh's bounding sphere. One texture
+// holds albedo (alpha = coverage), the other the model-space normal as 0..1. Far trees draw as one
+// quad showing the frame nearest their view direction (impostor.vert), lit like the mesh.
+// Frame (i, j) sits at column i, row j; its direction is HemiOctDecode of (i, j) / (frames - 1)
+// mapped to -1..1, and its image plane is spanned by FrameBasis of that direction.
+
+class TreeImpostor
+{
+public:
+    // Renders the atlas. treeMinY / treeMaxY / trunkFrac are the tree shader's, so the bark and
+    // leaf split matches the mesh. Leaves the default framebuffer bound; the caller restores the
+    // viewport. Returns false (and keeps nothing) if the bake shader or framebuffer fails.
+    bool Bake(const GLMesh& mesh, const Aabb& boundsMS, float treeMinY, float treeMaxY, float trunkFrac,
+        int frames, int frameSize);
+    void Destroy();
+
+    bool Ready() const { return albedoTex != 0; }
+    GLuint AlbedoTexture() const { return albedoTex; }
+    GLuint NormalTexture() const { return normalTex; }
+    int Frames() const { return frames; }
+
+    // Model-space bounding sphere the frames were shot around (xyz = centre, w = radius)
+    const glm::vec4& Sphere() const { return sphere; }
+
+    static glm::vec3 HemiOctDecode(const glm::vec2& e);
+    static void FrameBasis(const glm::vec3& dir, glm::vec3& right, glm::vec3& up);
+
+private:
+    GLuint albedoTex = 0;
+    GLuint normalTex = 0;
+    int frames = 0;
+    glm::vec4 sphere{ 0.0f };
+};
@@ -0,0 +1,185 @@
+#include "WorldGen.h"
+#include <cstddef>
+
+// GL half of TreeSystem; the world generation bench does not link this file
+
+namespace
+{
+    void SetMeshAttribs(const GLMesh& mesh)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)offsetof(ModelVertex, pos));
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)offsetof(ModelVertex, normal));
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)offsetof(ModelVertex, uv));
+    }
+
+    // A mat4 per element of the bound GL_ARRAY_BUFFER, as four vec4 attributes from `location`
+    void SetMatrixAttribs(GLuint location, GLuint divisor)
+    {
+        std::size_t vec4Size = sizeof(glm::vec4);
+
+        for (GLuint i = 0; i < 4; i++)
+        {
+            glEnableVertexAttribArray(location + i);
+            glVertexAttribPointer(location + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * vec4Size));
+            glVertexAttribDivisor(location + i, divisor);
+        }
+    }
+}
+
+void TreeSystem::InitForMesh(const GLMesh& mesh)
+{
+    if (vao == 0) glGenVertexArrays(1, &vao);
+    if (instanceVBO == 0) glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(vao);
+    SetMeshAttribs(mesh);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    SetMatrixAttribs(3, 1);
+
+    glBindVertexArray(0);
+}
+
+void TreeSystem::InitLods(const GLMesh& lod0, const GLMesh& lod1)
+{
+    if (instanceVBO == 0) return;
+
+    if (cullVAO == 0) glGenVertexArrays(1, &cullVAO);
+    glBindVertexArray(cullVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    SetMatrixAttribs(0, 0);
+
+    const GLMesh* meshes[kLodCount] = { &lod0, &lod1, nullptr };
+    for (int k = 0; k < kLodCount; k++)
+    {
+        if (lodVAO[k] == 0) glGenVertexArrays(1, &lodVAO[k]);
+        if (lodVBO[k] == 0) glGenBuffers(1, &lodVBO[k]);
+        if (lodQuery[k] == 0) glGenQueries(1, &lodQuery[k]);
+
+        glBindVertexArray(lodVAO[k]);
+        if (meshes[k]) SetMeshAttribs(*meshes[k]);
+
+        glBindBuffer(GL_ARRAY_BUFFER, lodVBO[k]);
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(glm::mat4), nullptr, GL_DYNAMIC_COPY);
+        SetMatrixAttribs(3, 1);
+    }
+    lodCapacity = instances.size();
+    culled = false;
+
+    glBindVertexArray(0);
+}
+
+void TreeSystem::UploadInstances()
+{
+    if (instanceVBO == 0) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER,
+        instances.size() * sizeof(glm::mat4),
+        instances.empty() ? nullptr : instances.data(),
+        GL_DYNAMIC_DRAW);
+
+    // any LOD could end up with every tree
+    if (lodVBO[0] != 0)
+    {
+        for (int k = 0; k < kLodCount; k++)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, lodVBO[k]);
+            glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(glm::mat4), nullptr, GL_DYNAMIC_COPY);
+        }
+        lodCapacity = instances.size();
+    }
+    culled = false;
+}
+
+void TreeSystem::DrawInstanced(GLsizei indexCount) const
+{
+    if (instances.empty() || vao == 0) return;
+
+    glBindVertexArray(vao);
+    glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, (GLsizei)instances.size());
+    glBindVertexArray(0);
+}
+
+void TreeSystem::CullInstances()
+{
+    culled = false;
+    if (instances.empty() || cullVAO == 0 || lodCapacity < instances.size()) return;
+
+    for (int k = 0; k < kLodCount; k++)
+    {
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, (GLuint)k, lodVBO[k]);
+        glBeginQueryIndexed(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, (GLuint)k, lodQuery[k]);
+    }
+
+    glBeginTransformFeedback(GL_POINTS);
+    glBindVertexArray(cullVAO);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)instances.size());
+    glBindVertexArray(0);
+    glEndTransformFeedback();
+
+    for (int k = 0; k < kLodCount; k++)
+    {
+        glEndQueryIndexed(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, (GLuint)k);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, (GLuint)k, 0);
+    }
+    culled = true;
+}
+
+int TreeSystem::DrawLod(int lod, GLsizei indexCount) const
+{
+    if (!culled || lod < 0 || lod >= kLodCount) return 0;
+
+    GLuint count = 0;
+    glGetQueryObjectuiv(lodQuery[lod], GL_QUERY_RESULT, &count);
+    if (count == 0) return 0;
+
+    glBindVertexArray(lodVAO[lod]);
+    if (lod == kImpostorLod)
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+    else if (indexCount > 0)
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, (GLsizei)count);
+    glBindVertexArray(0);
+    return (int)count;
+}
+
+size_t TreeSystem::GpuBytes() const
+{
+    return (instances.size() + kLodCount * lodCapacity) * sizeof(glm::mat4);
+}
+
+void TreeSystem::ClearInstances()
+{
+    instances.clear();
+    UploadInstances();
+}
+
+void TreeSystem::Destroy()
+{
+    instances.clear();
+
+    if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
+    instanceVBO = 0;
+
+    if (vao) glDeleteVertexArrays(1, &vao);
+    vao = 0;
+
+    if (cullVAO) glDeleteVertexArrays(1, &cullVAO);
+    cullVAO = 0;
+
+    glDeleteVertexArrays(kLodCount, lodVAO);
+    glDeleteBuffers(kLodCount, lodVBO);
+    glDeleteQueries(kLodCount, lodQuery);
+    for (int k = 0; k < kLodCount; k++) lodVAO[k] = lodVBO[k] = lodQuery[k] = 0;
+    lodCapacity = 0;
+    culled = false;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <string>
+#include <glm/glm/glm.hpp>
+
+struct WorldConfig
+{
+    float oceanHalfSize = 600.0f;
+
+    int islandCount = 7;
+    float islandSpawnRadius = 420.0f;
+    float islandMinSpacing = 160.0f;
+
+    // Streaming world (instead of the fixed islandCount layout): the ocean is split into square
+    // cells, each holding at most one island, generated around the camera and evicted behind it
+    bool streamingWorld = false;
+    float streamCellSize = 320.0f;
+    float streamIslandChance = 0.6f;   // chance a cell has an island
+    int streamLoadRadius = 2;          // cells around the camera's cell that are generated
+    int streamDropRadius = 5;          // cells further out are always evicted
+    // Island GPU memory kept before evicting outside the load radius. An island holds about 0.7 MB
+    // (terrain texture + tree buffers), so this is ~23 islands: the ~15 of the load radius plus a
+    // few behind the camera, well short of the ~70 the drop radius would keep.
+    int streamGpuBudgetMB = 16;
+
+    // Terrain
+    int terrainGrid = 250;
+    float terrainSpacing = 0.4f;
+    float seaLevel = 2.5f;
+
+    // Terrain LOD: quads per patch side, grid cells per finest node, finest band radius (metres)
+    int terrainLodPatchQuads = 16;
+    int terrainLodLeafCells = 8;
+    float terrainLodBaseRange = 14.0f;
+
+    // Trees (Forest / Grassland islands): target count and minimum trunk-to-trunk distance
+    int treesPerIsland = 800;
+    float treeMinSpacing = 1.2f;
+
+    // Tree LOD, picked per tree on the GPU (T toggles): full mesh up to treeLodDistance, then a
+    // simplified mesh clustered on a treeLodClusterCells grid, then an impostor from
+    // treeImpostorDistance (dithered over the treeImpostorFade before it); none past
+    // treeDrawDistance or the fog
+    bool gpuTreeCulling = true;
+    float treeLodDistance = 40.0f;
+    float treeDrawDistance = 400.0f;
+    int treeLodClusterCells = 10;
+
+    // Impostor atlas, baked at startup: treeImpostorFrames^2 views of treeImpostorFrameSize pixels
+    bool treeImpostors = true;
+    float treeImpostorDistance = 70.0f;
+    float treeImpostorFade = 10.0f;
+    int treeImpostorFrames = 8;
+    int treeImpostorFrameSize = 128;
+
+    // Villages: houses per Village island and the clearance kept around each one
+    int housesPerVillage = 8;
+    float houseRadius = 5.0f;
+
+    // Water
+    float waterSpacing = 1.0f;         // of the finest clipmap level; each level out doubles it
+    int waterClipmapCells = 32;        // cells per half side of each level
+    float waveStrength = 1.2f;
+    float waveSpeed = 1.0f;
+
+    // Rendering / atmosphere
+    bool fogEnabled = true;
+    float fogDensity = 0.028f;
+    glm::vec3 fogColor = glm::vec3(0.02f, 0.03f, 0.06f);
+
+    // Skip islands, their props and rings outside the view frustum (C toggles)
+    bool frustumCulling = true;
+
+    // Day/Night Speed
+    float timeSpeed = 0.05f;
+
+    // PCG seed
+    int seed = 1337;
+
+    // World generation worker threads (0 = all hardware threads)
+    int genThreads = 0;
+
+    // Main-thread time per frame spent uploading a regenerated world (ms)
+    float regenUploadBudgetMs = 4.0f;
+
+    // On-disk heightfield cache (skips noise for seeds already visited)
+    bool terrainCacheEnabled = true;
+    std::string terrainCacheDir = "cache/terrain";
+    int terrainCacheMaxMB = 256; // oldest entries are deleted past this
+
+    // Storm mode
+    bool stormMode = false;
+    float stormFogMultiplier = 2.5f;
+    float stormWaveMultiplier = 1.8f;
+
+    // Lighthouse placement / lighting
+    float lighthouseChancePerIsland = 0.55f; // 0..1
+    float lighthouseScale = 2.70f;
+    float lighthouseClearRadius = 4.0f;      // no trees / houses within this of the tower
+    float lighthouseLanternHeight = 10.0f;  
+    float lighthouseLightStrength = 25.0f;    // brightness multiplier at full night
+
+    // Lighthouse beam tuning
+    float lighthouseBeamSpinSpeed = 0.35f;  // radians/sec
+    float lighthouseBeamLength = 40.0f;  // used as a scale multiplier 
+    float lighthouseBeamRadius = 6.0f;  // used as a scale multiplier 
+    float lighthouseBeamStrength = 6.5f;  // brightness of the visible cone
+
+
+};
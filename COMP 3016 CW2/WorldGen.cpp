@@ -0,0 +1,586 @@
+#include "WorldGen.h"
+#include "RingSystem.h"
+#include "JobPool.h"
+#include "Scatter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <glm/glm/gtc/matrix_transform.hpp>
+#include <glm/glm/gtc/constants.hpp>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point a, Clock::time_point b)
+    {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+}
+
+uint64_t WorldChecksum(const std::vector<Island>& islands)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (const auto& isl : islands)
+    {
+        const auto& hts = isl.terrain.Heights();
+        const auto& moist = isl.terrain.Moisture();
+        const auto& t = isl.trees.Instances();
+        h = HashBytes(h, &isl.centerXZ, sizeof(isl.centerXZ));
+        h = HashBytes(h, &isl.biome, sizeof(isl.biome));
+        h = HashBytes(h, hts.data(), hts.size() * sizeof(float));
+        h = HashBytes(h, moist.data(), moist.size() * sizeof(float));
+        h = HashBytes(h, t.data(), t.size() * sizeof(glm::mat4));
+        for (const auto& house : isl.houses)
+        {
+            h = HashBytes(h, &house.model, sizeof(house.model));
+            h = HashBytes(h, &house.variant, sizeof(house.variant));
+        }
+        h = HashBytes(h, &isl.hasLighthouse, sizeof(isl.hasLighthouse));
+        if (isl.hasLighthouse)
+            h = HashBytes(h, &isl.lighthouseModel, sizeof(isl.lighthouseModel));
+    }
+    return h;
+}
+
+uint64_t RingsChecksum(uint64_t h, const RingSystem& rings)
+{
+    for (const auto& r : rings.Rings())
+    {
+        h = HashBytes(h, &r.posWS, sizeof(r.posWS));
+        h = HashBytes(h, &r.yaw, sizeof(r.yaw));
+        h = HashBytes(h, &r.pitch, sizeof(r.pitch));
+        h = HashBytes(h, &r.scale, sizeof(r.scale));
+    }
+    return h;
+}
+
+//  TreeSystem (CPU)
+
+void TreeSystem::PlaceOnTerrain(const Terrain& terrain,
+    int seed,
+    const glm::vec3& worldOffset,
+    const glm::vec3& pivotMS,
+    int desiredTrees,
+    float minSpacing,
+    const PropSpatialHash* avoid,
+    JobPool* pool)
+{
+    instances.clear();
+    if (desiredTrees <= 0 || terrain.SampleCount() == 0) return;
+
+    const float slopeLimit = 0.80f;
+    const float minMoisture = 0.45f;
+    const float minHeight = terrain.seaLevel + 0.12f;
+
+    const float TREE_SHRINK = 0.30f;
+
+    const auto& heights = terrain.Heights();
+    const auto& moisture = terrain.Moisture();
+    const int side = terrain.GridSize() + 1;
+    const float spacing = terrain.Spacing();
+    const float half = terrain.HalfSize();
+    const float trunkRadius = minSpacing * 0.5f;
+
+    PoissonDiskGrid disk;
+    disk.Init(glm::vec2(-half), glm::vec2(half), minSpacing);
+
+    // Bands of whole rows at least 4 * minSpacing tall, so two bands with one between them never
+    // touch the same disk cells (PoissonDiskGrid) and can be filled at the same time. Trees stay
+    // inside their band; the ones along a band edge are spaced against the neighbour's when the
+    // second half of the bands runs. Also keeps each band's disk and terrain lookups local.
+    struct Band
+    {
+        int row0 = 0, row1 = 0;
+        AliasTable suitable;
+        int quota = 0;
+        std::vector<glm::mat4> trees;
+    };
+    const int bandRows = std::max(16, (int)std::ceil(4.0f * minSpacing / spacing));
+    std::vector<Band> bands(std::max(1, side / bandRows));
+    for (int k = 0; k < (int)bands.size(); k++)
+    {
+        bands[k].row0 = k * bandRows;
+        bands[k].row1 = k + 1 == (int)bands.size() ? side : (k + 1) * bandRows;
+    }
+
+    auto forBands = [&](int first, int stride, const std::function<void(Band&, int)>& body)
+        {
+            int count = ((int)bands.size() - first + stride - 1) / stride;
+            auto run = [&](int begin, int end)
+                {
+                    for (int j = begin; j < end; j++) body(bands[first + j * stride], first + j * stride);
+                };
+            if (pool && count > 1) pool->ParallelFor(count, 1, run);
+            else run(0, count);
+        };
+
+    // Suitability of every grid sample: 0 where a tree may not stand, else the old acceptance
+    // chance (moisture above the threshold, squared). Cheap tests first, the normal last.
+    forBands(0, 1, [&](Band& band, int)
+        {
+            std::vector<float> weights((size_t)(band.row1 - band.row0) * side, 0.0f);
+            for (size_t w = 0; w < weights.size(); w++)
+            {
+                size_t i = (size_t)band.row0 * side + w;
+                if (heights[i] < minHeight || moisture[i] < minMoisture) continue;
+                if (terrain.NormalAt((int)i).y < slopeLimit) continue;
+
+                float prob = glm::clamp((moisture[i] - minMoisture) / (1.0f - minMoisture), 0.0f, 1.0f);
+                weights[w] = prob * prob;
+            }
+            band.suitable.Build(weights);
+        });
+
+    // Each band's share of the trees, rounded on the running total so the shares add up
+    double total = 0.0;
+    for (const Band& band : bands) total += band.suitable.TotalWeight();
+    if (total <= 0.0) return;
+
+    double before = 0.0;
+    for (Band& band : bands)
+    {
+        double after = before + band.suitable.TotalWeight();
+        band.quota = (int)std::llround(desiredTrees * after / total) - (int)std::llround(desiredTrees * before / total);
+        before = after;
+    }
+
+    // Adds up to `want` trees to the band, drawing from the stream keyed by (seed, band, pass)
+    auto fill = [&](Band& band, int index, int pass, int want)
+        {
+            if (want <= 0 || band.suitable.Empty()) return;
+            const size_t target = band.trees.size() + want;
+            band.trees.reserve(target);
+
+            std::seed_seq seq{ seed, index, pass };
+            std::mt19937 rng(seq);
+            std::uniform_real_distribution<float> rotY(0.0f, glm::two_pi<float>());
+            std::uniform_real_distribution<float> scaleR(0.8f, 1.5f);
+
+            // the band's rows, each with the grid cell on its +z side
+            const float zLo = band.row0 * spacing - half;
+            const float zHi = std::min(band.row1 * spacing - half, half);
+            const size_t firstSample = (size_t)band.row0 * side;
+
+            // Candidates come from the suitability table, so almost all of them are on valid ground and
+            // the only rejections left are spacing ones (they grow as the area fills up).
+            const int maxTries = want * 4;
+            const int chunk = 256;
+            float cx[chunk], cz[chunk], ch[chunk];
+
+            for (int tries = 0; tries < maxTries && band.trees.size() < target; tries += chunk)
+            {
+                int count = 0;
+                int draws = std::min(chunk, maxTries - tries);
+                for (int k = 0; k < draws; k++)
+                {
+                    glm::vec3 local = terrain.GridPoint((int)(firstSample + band.suitable.Sample(rng)));
+
+                    // one draw for both jitter axes (16 bits each) across the grid cell on the sample's
+                    // +x/+z side, which Terrain::SampleIndex maps back to the same sample: its slope and
+                    // moisture are the ones the table already checked
+                    uint32_t j = rng();
+                    float jx = (float)(j & 0xFFFF) * (1.0f / 65536.0f) * spacing;
+                    float jz = (float)(j >> 16) * (1.0f / 65536.0f) * spacing;
+
+                    glm::vec2 p(std::min(local.x + jx, half), glm::clamp(local.z + jz, zLo, zHi));
+
+                    // most late rejections are spacing ones; skip the terrain lookups for those
+                    if (!disk.IsFree(p)) continue;
+                    if (avoid && avoid->Overlaps(p, trunkRadius)) continue;
+                    cx[count] = p.x;
+                    cz[count] = p.y;
+                    count++;
+                }
+
+                terrain.SampleBatch(cx, cz, count, ch, nullptr, nullptr);
+
+                for (int k = 0; k < count && band.trees.size() < target; k++)
+                {
+                    // the interpolated height can still dip below the sample's
+                    if (ch[k] < minHeight) continue;
+                    if (!disk.TryInsert(glm::vec2(cx[k], cz[k]))) continue;
+
+                    float s = scaleR(rng) * TREE_SHRINK;
+                    float r = rotY(rng);
+
+                    // translate(world) * rotate(r, Y) * scale(s) * translate(-pivot), written out
+                    float c = std::cos(r) * s, sn = std::sin(r) * s;
+                    glm::mat4 M(1.0f);
+                    M[0] = glm::vec4(c, 0.0f, -sn, 0.0f);
+                    M[1] = glm::vec4(0.0f, s, 0.0f, 0.0f);
+                    M[2] = glm::vec4(sn, 0.0f, c, 0.0f);
+                    glm::vec3 world = glm::vec3(cx[k], ch[k], cz[k]) + worldOffset;
+                    M[3] = glm::vec4(world - glm::mat3(M) * pivotMS, 1.0f);
+
+                    band.trees.push_back(M);
+                }
+            }
+        };
+
+    auto fillQuota = [&](Band& band, int index) { fill(band, index, 0, band.quota); };
+    forBands(0, 2, fillQuota);
+    forBands(1, 2, fillQuota);
+
+    // Bands that filled up leave part of their quota over; offer it to the others in turn (serial,
+    // so the result stays the same with or without a pool).
+    int placed = 0;
+    for (const Band& band : bands) placed += (int)band.trees.size();
+    for (int k = 0; k < (int)bands.size() && placed < desiredTrees; k++)
+    {
+        size_t had = bands[k].trees.size();
+        fill(bands[k], k, 1, desiredTrees - placed);
+        placed += (int)(bands[k].trees.size() - had);
+    }
+
+    instances.reserve(desiredTrees);
+    for (const Band& band : bands) instances.insert(instances.end(), band.trees.begin(), band.trees.end());
+}
+
+//  WorldGenerator
+
+IslandBiome WorldGenerator::PickIslandBiome(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    float r = u(rng);
+
+    if (r < 0.30f) return IslandBiome::Forest;
+    if (r < 0.55f) return IslandBiome::Grassland;
+    if (r < 0.70f) return IslandBiome::Snow;
+    if (r < 0.85f) return IslandBiome::Desert;
+    return IslandBiome::Village;
+}
+
+bool WorldGenerator::FindLighthouseSpot(const Terrain& t, glm::vec3& outLocalPos) const
+{
+    const auto& coast = t.Coast().Segments();
+    if (coast.empty()) return false;
+
+    float half = t.HalfSize();
+    float sea = t.seaLevel;
+
+    // A few steps inland from the middle of every shore segment, scored in one batch
+    const float inland[3] = { 1.0f, 2.0f, 3.0f };
+    const int count = (int)coast.size() * 3;
+
+    std::vector<float> cx(count), cz(count), ch(count);
+    std::vector<glm::vec3> cn(count);
+    for (int s = 0; s < (int)coast.size(); s++)
+    {
+        glm::vec2 mid = (coast[s].a + coast[s].b) * 0.5f;
+        for (int k = 0; k < 3; k++)
+        {
+            glm::vec2 p = mid - coast[s].outward * inland[k];
+            cx[s * 3 + k] = p.x;
+            cz[s * 3 + k] = p.y;
+        }
+    }
+    t.SampleBatch(cx.data(), cz.data(), count, ch.data(), cn.data(), nullptr);
+
+    float bestScore = -1e9f;
+    int bestIdx = -1;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (ch[i] < sea + 0.10f) continue;
+        if (ch[i] > sea + 2.20f) continue;
+
+        // outer coast over lake shores
+        float r = glm::length(glm::vec2(cx[i], cz[i]));
+        float edge01 = glm::clamp((r - half * 0.70f) / (half * 0.28f), 0.0f, 1.0f);
+
+        float flat01 = glm::clamp((cn[i].y - 0.75f) / (1.0f - 0.75f), 0.0f, 1.0f);
+
+        float score = edge01 * 2.0f + flat01 * 1.5f;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestIdx = i;
+        }
+    }
+
+    if (bestIdx < 0) return false;
+
+    outLocalPos = glm::vec3(cx[bestIdx], ch[bestIdx], cz[bestIdx]);
+    return true;
+}
+
+void WorldGenerator::GenerateIslandCPU(Island& isl, const TerrainCache* cache, JobPool* pool) const
+{
+    isl.terrain.seaLevel = cfg.seaLevel;
+    isl.terrain.lodLeafCells = cfg.terrainLodLeafCells;
+    isl.terrain.Build(cfg.terrainGrid, cfg.terrainSpacing, isl.seed, isl.biome, cache, pool);
+
+    PropScatter props;
+    props.Begin(isl.terrain, cfg.houseRadius * 2.0f);
+
+    // Lighthouse first: it has one fixed spot, everything else works around it
+    auto t0 = Clock::now();
+    isl.lighthouseSpotFound = assets.lighthouseLoaded && FindLighthouseSpot(isl.terrain, isl.lighthouseSpotLocal);
+    if (isl.wantLighthouse && isl.lighthouseSpotFound)
+        props.Reserve(glm::vec2(isl.lighthouseSpotLocal.x, isl.lighthouseSpotLocal.z), cfg.lighthouseClearRadius);
+
+    auto t1 = Clock::now();
+    isl.houses.clear();
+    if (isl.biome == IslandBiome::Village && assets.houseVariants > 0)
+        PlaceVillageHouses(isl, props);
+
+    // Trees
+    auto t2 = Clock::now();
+    isl.spawnTrees = assets.treesLoaded &&
+        ((isl.biome == IslandBiome::Forest) || (isl.biome == IslandBiome::Grassland));
+    if (isl.spawnTrees)
+    {
+        glm::vec3 islandOffset(isl.centerXZ.x, 0.0f, isl.centerXZ.y);
+        isl.trees.PlaceOnTerrain(isl.terrain, isl.seed + 555, islandOffset, assets.treePivotMS,
+            cfg.treesPerIsland, cfg.treeMinSpacing, &props.Occupied(), pool);
+    }
+    auto t3 = Clock::now();
+
+    isl.genTimings.lighthouseMs = ElapsedMs(t0, t1);
+    isl.genTimings.housesMs = ElapsedMs(t1, t2);
+    isl.genTimings.treesMs = ElapsedMs(t2, t3);
+}
+
+void WorldGenerator::PlaceVillageHouses(Island& isl, PropScatter& props) const
+{
+    // Place a small village on the flatter mid-band area (same idea as Terrain flatten mask),
+    // away from the coast and low land.
+    PropType house;
+    house.radius = cfg.houseRadius;
+    house.minNormalY = 0.90f;
+    house.minHeight = cfg.seaLevel + 1.5f;
+    house.minRadial01 = 0.20f;
+    house.maxRadial01 = 0.70f;
+    house.keepChance = 0.35f; // so villages vary per seed
+
+    // Own stream per island, so villages do not depend on the layout order
+    std::mt19937 rng(isl.seed + 777);
+    std::uniform_real_distribution<float> yawR(0.0f, glm::two_pi<float>());
+    std::uniform_real_distribution<float> scaleR(2.0f, 3.0f);
+
+    std::vector<PropScatter::Placed> spots;
+    props.Place(house, cfg.housesPerVillage, cfg.housesPerVillage * 30, rng, spots);
+
+    glm::vec3 worldOffset(isl.centerXZ.x, 0.0f, isl.centerXZ.y);
+    isl.houses.reserve(spots.size());
+    for (const auto& spot : spots)
+    {
+        float yaw = yawR(rng);
+        float s = scaleR(rng);
+
+        glm::mat4 T = glm::translate(glm::mat4(1.0f), spot.local + worldOffset);
+        glm::mat4 R = glm::rotate(glm::mat4(1.0f), yaw, glm::vec3(0, 1, 0));
+        glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(s));
+
+        PlacedHouse ph;
+        ph.variant = (int)(rng() % (unsigned int)assets.houseVariants);
+        ph.model = T * R * S;
+
+        if (ph.variant < (int)assets.houseBoundsMS.size())
+            ph.bounds = TransformAabb(assets.houseBoundsMS[ph.variant], ph.model);
+        if (ph.bounds.Empty())
+            ph.bounds.AddSphere(spot.local + worldOffset, cfg.houseRadius * s);
+
+        isl.houses.push_back(ph);
+    }
+}
+
+// Lays out the islands and generates all of their CPU data (no GL).
+// Every draw from the shared layout rng stays on the calling thread, in the same order as the
+// original serial loop, so the output is identical for any pool size. Islands are handed to the
+// pool as soon as their biome and lighthouse roll are known; everything placed on an island
+// draws from that island's own seed, so the layout never waits on a job.
+// pool == nullptr runs every island inline and is the serial reference path.
+void WorldGenerator::GenerateIslands(int seed, JobPool* pool, const TerrainCache* cache, std::vector<Island>& out) const
+{
+    out.clear();
+    out.resize(cfg.islandCount);
+
+    std::vector<std::future<void>> jobs(cfg.islandCount);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> ang(0.0f, glm::two_pi<float>());
+    std::uniform_real_distribution<float> rad(0.0f, cfg.islandSpawnRadius);
+    std::uniform_real_distribution<float> chance01(0.0f, 1.0f);
+
+    // Islands are discs of half the minimum spacing, so two overlap exactly when their centres
+    // are closer than islandMinSpacing
+    const float islandRadius = cfg.islandMinSpacing * 0.5f;
+    PropSpatialHash placed;
+    placed.Init(cfg.islandMinSpacing, cfg.islandCount);
+
+    for (int i = 0; i < cfg.islandCount; i++)
+    {
+        glm::vec2 pos(0.0f);
+        bool ok = false;
+
+        for (int tries = 0; tries < 300; tries++)
+        {
+            float a = ang(rng);
+            float r = rad(rng);
+            pos = glm::vec2(cos(a), sin(a)) * r;
+
+            if (!placed.Overlaps(pos, islandRadius))
+            {
+                ok = true;
+                break;
+            }
+        }
+
+        if (!ok)
+        {
+            float a = ang(rng);
+            float r = rad(rng);
+            pos = glm::vec2(cos(a), sin(a)) * r;
+        }
+
+        placed.Insert(pos, islandRadius);
+
+        Island& isl = out[i];
+        isl.centerXZ = pos;
+        isl.seed = seed + i * 9991;
+
+        isl.biome = PickIslandBiome(rng);
+
+        isl.model = glm::translate(glm::mat4(1.0f), glm::vec3(pos.x, 0.0f, pos.y));
+
+        // Rolled before the job so its spot can be kept clear; the spot comes from the job
+        isl.wantLighthouse = assets.lighthouseLoaded && chance01(rng) < cfg.lighthouseChancePerIsland;
+
+        if (pool)
+            jobs[i] = pool->Submit([this, &isl, cache, pool]() { GenerateIslandCPU(isl, cache, pool); });
+        else
+            GenerateIslandCPU(isl, cache, nullptr);
+    }
+
+    for (auto& j : jobs)
+        if (j.valid()) j.get();
+
+    for (auto& isl : out)
+    {
+        FinishLighthouse(isl);
+        ComputeBounds(isl);
+    }
+}
+
+void WorldGenerator::FinishLighthouse(Island& isl) const
+{
+    isl.hasLighthouse = false;
+    if (!isl.wantLighthouse || !isl.lighthouseSpotFound) return;
+
+    glm::vec3 localSpot = isl.lighthouseSpotLocal;
+    glm::vec3 worldOffset(isl.centerXZ.x, 0.0f, isl.centerXZ.y);
+    glm::vec3 posWS = localSpot + worldOffset;
+
+    glm::vec2 d = glm::normalize(glm::vec2(localSpot.x, localSpot.z));
+    float yaw = atan2(d.y, d.x) + glm::pi<float>(); // face outward
+
+    glm::mat4 T = glm::translate(glm::mat4(1.0f), posWS);
+    glm::mat4 R = glm::rotate(glm::mat4(1.0f), yaw, glm::vec3(0, 1, 0));
+    glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(cfg.lighthouseScale));
+
+    isl.lighthouseModel = T * R * S;
+    isl.lighthousePosWS = posWS;
+    isl.hasLighthouse = true;
+}
+
+void WorldGenerator::ComputeBounds(Island& isl) const
+{
+    const float half = isl.terrain.HalfSize();
+    const glm::vec3 centre(isl.centerXZ.x, 0.0f, isl.centerXZ.y);
+
+    Aabb b;
+    b.Add(centre + glm::vec3(-half, std::min(isl.terrain.MinHeight(), cfg.seaLevel), -half));
+    b.Add(centre + glm::vec3(half, isl.terrain.MaxHeight(), half));
+
+    for (const auto& house : isl.houses)
+        b.Add(house.bounds);
+    for (const glm::mat4& m : isl.trees.Instances())
+        b.Add(TransformAabb(assets.treeBoundsMS, m));
+
+    isl.lighthouseBounds = Aabb();
+    isl.beamSphere = glm::vec4(0.0f);
+    if (isl.hasLighthouse)
+    {
+        glm::vec3 lantern = isl.lighthousePosWS + glm::vec3(0.0f, cfg.lighthouseLanternHeight * cfg.lighthouseScale, 0.0f);
+
+        isl.lighthouseBounds = TransformAabb(assets.lighthouseBoundsMS, isl.lighthouseModel);
+        if (isl.lighthouseBounds.Empty())
+        {
+            isl.lighthouseBounds.AddSphere(isl.lighthousePosWS, cfg.lighthouseClearRadius);
+            isl.lighthouseBounds.AddSphere(lantern, cfg.lighthouseClearRadius);
+        }
+
+        // the cone spins about the lantern: its length and base radius bound it in any direction
+        float reach = std::sqrt(cfg.lighthouseBeamLength * cfg.lighthouseBeamLength
+            + cfg.lighthouseBeamRadius * cfg.lighthouseBeamRadius);
+        isl.beamSphere = glm::vec4(lantern, reach);
+
+        b.Add(isl.lighthouseBounds);
+        b.AddSphere(lantern, reach);
+    }
+
+    isl.bounds = b;
+}
+
+// Everything comes from a hash of (seed, cellX, cellZ), so a cell turns out the same whenever
+// and in whatever order it is generated. The island stays islandMinSpacing / 2 inside its cell,
+// which keeps islands of neighbouring cells at least islandMinSpacing apart.
+bool WorldGenerator::GenerateCellIsland(int seed, int cellX, int cellZ, JobPool* pool, const TerrainCache* cache, Island& isl) const
+{
+    uint32_t h = (uint32_t)seed * 0x9E3779B1u ^ (uint32_t)cellX * 0x85EBCA77u ^ (uint32_t)cellZ * 0xC2B2AE3Du;
+    h ^= h >> 16; h *= 0x7FEB352Du;
+    h ^= h >> 15; h *= 0x846CA68Bu;
+    h ^= h >> 16;
+
+    std::mt19937 rng(h);
+    std::uniform_real_distribution<float> chance01(0.0f, 1.0f);
+    if (chance01(rng) >= cfg.streamIslandChance) return false;
+
+    const float cell = cfg.streamCellSize;
+    const float margin = std::min(cfg.islandMinSpacing * 0.5f, cell * 0.5f);
+    glm::vec2 pos(cellX * cell + margin + chance01(rng) * (cell - 2.0f * margin),
+        cellZ * cell + margin + chance01(rng) * (cell - 2.0f * margin));
+
+    isl.centerXZ = pos;
+    isl.seed = (int)(h & 0x7FFFFFFFu);
+    isl.biome = PickIslandBiome(rng);
+    isl.model = glm::translate(glm::mat4(1.0f), glm::vec3(pos.x, 0.0f, pos.y));
+    isl.wantLighthouse = assets.lighthouseLoaded && chance01(rng) < cfg.lighthouseChancePerIsland;
+
+    GenerateIslandCPU(isl, cache, pool);
+    FinishLighthouse(isl);
+    ComputeBounds(isl);
+    return true;
+}
+
+void WorldGenerator::SpawnRings(const std::vector<Island>& islands, int seed, RingSystem& rings) const
+{
+    for (int i = 0; i < (int)islands.size(); i++)
+        SpawnIslandRings(islands[i], i, seed, rings);
+}
+
+void WorldGenerator::SpawnIslandRings(const Island& isl, int islandIndex, int seed, RingSystem& rings) const
+{
+    int ringCount = 6;
+    if (isl.biome == IslandBiome::Village) ringCount = 10;
+    if (isl.biome == IslandBiome::Snow)    ringCount = 7;
+
+    rings.SpawnForIsland(
+        islandIndex,
+        isl.centerXZ,
+        isl.terrain.HalfSize(),
+        ringCount,
+        seed,
+        // height + normal + distance to shore sampler (local xz)
+        [&](const float* lx, const float* lz, int n, float* outHeight, glm::vec3* outNormal, float* outShore)
+        {
+            isl.terrain.SampleBatch(lx, lz, n, outHeight, outNormal, nullptr);
+            isl.terrain.Coast().DistanceBatch(lx, lz, n, outShore);
+        }
+    );
+}
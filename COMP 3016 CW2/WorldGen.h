@@ -0,0 +1,210 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm/glm.hpp>
+#include "MeshTypes.h"
+#include "Terrain.h"
+#include "WorldConfig.h"
+#include "Frustum.h"
+
+class TerrainCache;
+class JobPool;
+class RingSystem;
+class PropSpatialHash;
+class PropScatter;
+
+//  World generation
+// Everything that turns a seed into islands, trees, houses, lighthouses and rings. No GL calls
+// outside TreeSystemGL.cpp / TerrainGL.cpp, so it also links into the headless WorldGenBench.
+
+struct PlacedHouse
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    int variant = 0;
+    Aabb bounds;                   // world space
+};
+
+//  Tree System
+
+// Instance transforms for one island's trees. PlaceOnTerrain is CPU only (WorldGen.cpp);
+// the VAO / instance buffer side lives in TreeSystemGL.cpp.
+class TreeSystem
+{
+public:
+    void InitForMesh(const GLMesh& mesh);
+
+    // Blue-noise scatter: positions are drawn from a moisture/slope/height suitability table and
+    // kept at least minSpacing apart, up to desiredTrees. Each tree takes a disc of minSpacing / 2,
+    // which must stay clear of everything in `avoid` (other props, island-local).
+    // The island is split into bands of rows, each with its own table and a share of the trees
+    // by weight; with a pool, alternate bands run in parallel. The result does not depend on pool.
+    void PlaceOnTerrain(const Terrain& terrain,
+        int seed,
+        const glm::vec3& worldOffset,
+        const glm::vec3& pivotMS,
+        int desiredTrees,
+        float minSpacing,
+        const PropSpatialHash* avoid = nullptr,
+        JobPool* pool = nullptr);
+
+    const std::vector<glm::mat4>& Instances() const { return instances; }
+
+    void UploadInstances();
+    void DrawInstanced(GLsizei indexCount) const;
+    void ClearInstances();
+    void Destroy();
+
+    // GPU culling and LOD. LOD 0 is the full tree mesh, LOD 1 a simplified one, LOD 2 the
+    // impostor quad (TreeImpostor), which has no mesh.
+    static constexpr int kLodCount = 3;
+    static constexpr int kImpostorLod = 2;
+
+    // Sets up the LOD draws (call after InitForMesh; UploadInstances sizes their buffers)
+    void InitLods(const GLMesh& lod0, const GLMesh& lod1);
+
+    // With the tree cull program bound and GL_RASTERIZER_DISCARD on, runs every instance through
+    // it. The survivors of each LOD land in that LOD's instance buffer, their count in a query.
+    void CullInstances();
+
+    // Draws the instances the last CullInstances kept for one LOD with the bound shader: mesh LODs
+    // with indexCount indices, the impostor as a 4-vertex strip each. Reads that LOD's cull query,
+    // which waits for the cull pass, so run that well before. Returns the number drawn.
+    int DrawLod(int lod, GLsizei indexCount) const;
+
+    // Instance buffers, LOD buffers included
+    size_t GpuBytes() const;
+
+private:
+    GLuint vao = 0;
+    GLuint instanceVBO = 0;
+    std::vector<glm::mat4> instances;
+
+    GLuint cullVAO = 0;                 // instanceVBO as per-vertex input of the cull pass
+    GLuint lodVAO[kLodCount] = {};      // LOD mesh (if any) + lodVBO as per-instance input
+    GLuint lodVBO[kLodCount] = {};      // written by transform feedback, room for every instance
+    GLuint lodQuery[kLodCount] = {};    // primitives written to each stream
+    size_t lodCapacity = 0;             // instances each lodVBO holds
+    bool culled = false;                // CullInstances has run since the last upload
+};
+
+//  Island
+
+// Wall time of the placement stages of one island (terrain stages are in Terrain::LastBuildTimings)
+struct IslandGenTimings
+{
+    double treesMs = 0.0;
+    double housesMs = 0.0;
+    double lighthouseMs = 0.0;
+};
+
+struct Island
+{
+    Terrain terrain;
+    TreeSystem trees;
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec2 centerXZ = glm::vec2(0.0f);
+    int seed = 0;
+    IslandBiome biome = IslandBiome::Forest;
+    std::vector<PlacedHouse> houses;
+
+    // Lighthouse (one per island max)
+    bool hasLighthouse = false;
+    glm::vec3 lighthousePosWS{ 0.0f };
+    glm::mat4 lighthouseModel = glm::mat4(1.0f);
+
+    // World-space bounds for culling, filled at generation: `bounds` holds the terrain and
+    // everything on it, beam included; beamSphere is xyz = lantern, w = radius the beam can reach
+    Aabb bounds;
+    Aabb lighthouseBounds;
+    glm::vec4 beamSphere{ 0.0f };
+
+    // Lighthouse roll from the layout pass; the generation job then finds the spot and keeps the
+    // other props clear of it. hasLighthouse is set once both are in.
+    bool wantLighthouse = false;
+    bool spawnTrees = false;
+    bool lighthouseSpotFound = false;
+    glm::vec3 lighthouseSpotLocal{ 0.0f };
+
+    IslandGenTimings genTimings;
+};
+
+// FNV-1a over raw bytes; used to compare generated worlds between runs / thread counts
+inline uint64_t HashBytes(uint64_t h, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t WorldChecksum(const std::vector<Island>& islands);
+
+// Rings folded into a world checksum (positions, orientation, scale)
+uint64_t RingsChecksum(uint64_t h, const RingSystem& rings);
+
+//  WorldGenerator
+
+// What generation needs to know about loaded models, without the models themselves
+struct WorldGenAssets
+{
+    bool treesLoaded = false;
+    glm::vec3 treePivotMS{ 0.0f };
+    bool lighthouseLoaded = false;
+    int houseVariants = 0;        // 0 = no houses
+
+    // Model-space bounds, for the culling volumes; an empty box falls back to a size from the config
+    Aabb treeBoundsMS;
+    Aabb lighthouseBoundsMS;
+    std::vector<Aabb> houseBoundsMS;   // per variant
+};
+
+// Holds its own copy of the config and assets, so a rebuild running in the background is not
+// affected by anything the main thread changes meanwhile.
+class WorldGenerator
+{
+public:
+    WorldGenerator(const WorldConfig& cfg, const WorldGenAssets& assets) : cfg(cfg), assets(assets) {}
+
+    const WorldConfig& Config() const { return cfg; }
+
+    // Lays out the islands and generates all of their CPU data (no GL).
+    // pool == nullptr runs every island inline and is the serial reference path.
+    void GenerateIslands(int seed, JobPool* pool, const TerrainCache* cache, std::vector<Island>& out) const;
+
+    // Appends the rings of every island to `rings`
+    void SpawnRings(const std::vector<Island>& islands, int seed, RingSystem& rings) const;
+
+    // Appends the rings of one island; islandIndex picks its ring stream
+    void SpawnIslandRings(const Island& isl, int islandIndex, int seed, RingSystem& rings) const;
+
+    // Streaming worlds: the island of cell (cellX, cellZ), streamCellSize on a side, with all of
+    // its CPU data. Returns false (and leaves `isl` alone) if the cell is open sea.
+    bool GenerateCellIsland(int seed, int cellX, int cellZ, JobPool* pool, const TerrainCache* cache, Island& isl) const;
+
+private:
+    WorldConfig cfg;
+    WorldGenAssets assets;
+
+    static IslandBiome PickIslandBiome(std::mt19937& rng);
+
+    // Pick a coastline-ish position: near edge, not too steep, just above sea level.
+    bool FindLighthouseSpot(const Terrain& t, glm::vec3& outLocalPos) const;
+
+    // CPU half of one island: terrain, lighthouse spot, houses and trees, in that order through
+    // one PropScatter so each kind avoids the ones before it.
+    // Only touches `isl`, so it can run on a worker thread.
+    void GenerateIslandCPU(Island& isl, const TerrainCache* cache, JobPool* pool) const;
+
+    void PlaceVillageHouses(Island& isl, PropScatter& props) const;
+
+    // Lighthouse model matrix from the spot the generation job found (if it was rolled)
+    void FinishLighthouse(Island& isl) const;
+
+    // Culling volumes of a finished island (after FinishLighthouse)
+    void ComputeBounds(Island& isl) const;
+};
@@ -0,0 +1,263 @@
+#include "WorldStreamer.h"
+#include "JobPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+void WorldStreamer::Reset(const WorldGenerator& g, int newSeed)
+{
+    Clear();
+    gen = std::make_unique<WorldGenerator>(g);
+    seed = newSeed;
+    nextId = 1;
+}
+
+void WorldStreamer::Clear()
+{
+    // jobs write into their cell, so they have to finish before the cells go
+    for (auto& kv : cells)
+        if (kv.second.job.valid()) kv.second.job.wait();
+
+    cells.clear();
+    collectedRings.clear();
+    gen.reset();
+    counters = StreamCounters();
+}
+
+void WorldStreamer::CellOf(const glm::vec2& p, int& x, int& z) const
+{
+    const float size = gen->Config().streamCellSize;
+    x = (int)std::floor(p.x / size);
+    z = (int)std::floor(p.y / size);
+}
+
+float WorldStreamer::CellDistance2(const Cell& c, const glm::vec2& p) const
+{
+    const float size = gen->Config().streamCellSize;
+    glm::vec2 d = glm::vec2((c.x + 0.5f) * size, (c.z + 0.5f) * size) - p;
+    return glm::dot(d, d);
+}
+
+int WorldStreamer::CellRing(const Cell& c, int camX, int camZ) const
+{
+    return std::max(std::abs(c.x - camX), std::abs(c.z - camZ));
+}
+
+void WorldStreamer::CollectFinished()
+{
+    for (auto& kv : cells)
+    {
+        Cell& c = kv.second;
+        if (c.state != CellState::Generating) continue;
+        if (c.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) continue;
+
+        if (c.job.get())
+        {
+            c.state = CellState::Ready;
+        }
+        else
+        {
+            c.state = CellState::Sea;
+            c.result.reset();
+        }
+    }
+}
+
+void WorldStreamer::Recount()
+{
+    int resident = 0, queued = 0;
+    size_t bytes = 0;
+    for (const auto& kv : cells)
+    {
+        const Cell& c = kv.second;
+        if (c.state == CellState::Resident)
+        {
+            resident++;
+            bytes += c.gpuBytes;
+        }
+        else if (c.state == CellState::Generating || c.state == CellState::Ready)
+        {
+            queued++;
+        }
+    }
+    counters.residentIslands = resident;
+    counters.queueDepth = queued;
+    counters.gpuBytes = bytes;
+}
+
+void WorldStreamer::Update(const glm::vec2& cameraXZ, JobPool* pool, const TerrainCache* cache)
+{
+    if (!gen) return;
+    CollectFinished();
+
+    const WorldConfig& cfg = gen->Config();
+    int camX, camZ;
+    CellOf(cameraXZ, camX, camZ);
+
+    // finished cells nobody took before the camera left; running jobs are left to finish
+    for (auto it = cells.begin(); it != cells.end();)
+    {
+        const Cell& c = it->second;
+        bool idle = c.state == CellState::Ready || c.state == CellState::Sea;
+        if (idle && CellRing(c, camX, camZ) > cfg.streamDropRadius)
+            it = cells.erase(it);
+        else
+            ++it;
+    }
+
+    // square rings outward from the camera's cell, so near cells reach the pool first
+    const int radius = std::max(cfg.streamLoadRadius, 0);
+    for (int r = 0; r <= radius; r++)
+    {
+        for (int z = camZ - r; z <= camZ + r; z++)
+        {
+            for (int x = camX - r; x <= camX + r; x++)
+            {
+                if (std::max(std::abs(x - camX), std::abs(z - camZ)) != r) continue;
+
+                auto ins = cells.try_emplace(Key(x, z));
+                if (!ins.second) continue;
+
+                Cell& c = ins.first->second;
+                c.id = nextId++;
+                c.x = x;
+                c.z = z;
+                c.result = std::make_unique<StreamedIsland>();
+                c.result->cellId = c.id;
+
+                StreamedIsland* out = c.result.get();
+                const WorldGenerator* g = gen.get();
+                const int s = seed;
+                auto work = [g, s, x, z, pool, cache, out]()
+                    {
+                        if (!g->GenerateCellIsland(s, x, z, pool, cache, out->island)) return false;
+                        g->SpawnIslandRings(out->island, x * 7919 + z, s, out->rings);
+                        return true;
+                    };
+
+                if (pool)
+                {
+                    c.job = pool->Submit(work);
+                }
+                else
+                {
+                    std::promise<bool> done;
+                    done.set_value(work());
+                    c.job = done.get_future();
+                }
+            }
+        }
+    }
+
+    Recount();
+}
+
+std::unique_ptr<StreamedIsland> WorldStreamer::PopReady(const glm::vec2& cameraXZ)
+{
+    if (!gen) return nullptr;
+    CollectFinished();
+
+    Cell* best = nullptr;
+    uint64_t bestKey = 0;
+    float bestD2 = 0.0f;
+    for (auto& kv : cells)
+    {
+        Cell& c = kv.second;
+        if (c.state != CellState::Ready) continue;
+
+        float d2 = CellDistance2(c, cameraXZ);
+        if (!best || d2 < bestD2)
+        {
+            best = &c;
+            bestKey = kv.first;
+            bestD2 = d2;
+        }
+    }
+    if (!best) return nullptr;
+
+    best->state = CellState::Resident;
+    counters.generated++;
+    std::unique_ptr<StreamedIsland> out = std::move(best->result);
+
+    // the cell was generated from scratch, collected rings included
+    auto collected = collectedRings.find(bestKey);
+    if (collected != collectedRings.end()) out->rings.RemoveSpawned(collected->second);
+
+    Recount();
+    return out;
+}
+
+void WorldStreamer::MarkResident(int cellId, size_t gpuBytes)
+{
+    for (auto& kv : cells)
+    {
+        if (kv.second.id != cellId) continue;
+        kv.second.gpuBytes = gpuBytes;
+        break;
+    }
+    Recount();
+}
+
+void WorldStreamer::MarkCollected(int cellId, int spawnIndex)
+{
+    if (spawnIndex < 0) return;
+
+    for (const auto& kv : cells)
+    {
+        if (kv.second.id != cellId) continue;
+
+        std::vector<uint8_t>& flags = collectedRings[kv.first];
+        if ((size_t)spawnIndex >= flags.size()) flags.resize((size_t)spawnIndex + 1, 0);
+        flags[spawnIndex] = 1;
+        break;
+    }
+}
+
+void WorldStreamer::Evictions(const glm::vec2& cameraXZ, std::vector<int>& outCellIds)
+{
+    outCellIds.clear();
+    if (!gen) return;
+
+    const WorldConfig& cfg = gen->Config();
+    int camX, camZ;
+    CellOf(cameraXZ, camX, camZ);
+
+    // (distance², key) of resident cells that may go if memory is short
+    std::vector<std::pair<float, uint64_t>> spare;
+    for (auto it = cells.begin(); it != cells.end();)
+    {
+        const Cell& c = it->second;
+        int ring = CellRing(c, camX, camZ);
+        if (c.state == CellState::Resident && ring > cfg.streamDropRadius)
+        {
+            outCellIds.push_back(c.id);
+            it = cells.erase(it);
+            continue;
+        }
+        if (c.state == CellState::Resident && ring > cfg.streamLoadRadius)
+            spare.push_back({ CellDistance2(c, cameraXZ), it->first });
+        ++it;
+    }
+    Recount();
+
+    const size_t budget = (size_t)std::max(cfg.streamGpuBudgetMB, 0) * 1024 * 1024;
+    if (counters.gpuBytes > budget)
+    {
+        // farthest first
+        std::sort(spare.begin(), spare.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (const auto& s : spare)
+        {
+            if (counters.gpuBytes <= budget) break;
+
+            auto it = cells.find(s.second);
+            counters.gpuBytes -= it->second.gpuBytes;
+            outCellIds.push_back(it->second.id);
+            cells.erase(it);
+            counters.evictedForBudget++;
+        }
+        Recount();
+    }
+
+    counters.evicted += (int)outCellIds.size();
+}
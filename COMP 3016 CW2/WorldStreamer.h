@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <future>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <glm/glm/glm.hpp>
+#include "WorldGen.h"
+#include "RingSystem.h"
+
+class JobPool;
+class TerrainCache;
+
+//  WORLD STREAMER
+// Streaming ocean: square cells of streamCellSize around the camera, each with at most one island
+// generated from the seed and cell coordinates alone (WorldGenerator::GenerateCellIsland).
+// Cells are generated on the job pool as the camera comes near; the owner uploads finished islands
+// and frees their GPU resources when Evictions() hands their cells back. No GL calls here.
+
+struct StreamCounters
+{
+    int residentIslands = 0;       // handed over and uploaded
+    int queueDepth = 0;            // cells generating or waiting to be handed over
+    size_t gpuBytes = 0;           // as reported through MarkResident
+    int generated = 0;             // islands handed over since Reset
+    int evicted = 0;
+    int evictedForBudget = 0;      // of evicted, inside streamDropRadius but over streamGpuBudgetMB
+};
+
+// A generated island and its rings, ready for upload
+struct StreamedIsland
+{
+    int cellId = 0;                // names the cell in MarkResident / Evictions; never 0
+    Island island;
+    RingSystem rings;              // ring data only
+};
+
+class WorldStreamer
+{
+public:
+    ~WorldStreamer() { Clear(); }
+
+    // Forgets every cell (waiting for running jobs) and starts a new world
+    void Reset(const WorldGenerator& gen, int seed);
+    void Clear();
+
+    bool Active() const { return gen != nullptr; }
+
+    // Queues the cells within streamLoadRadius of the camera that are not known yet, nearest first,
+    // and forgets finished cells past streamDropRadius that were never handed over
+    void Update(const glm::vec2& cameraXZ, JobPool* pool, const TerrainCache* cache);
+
+    // Nearest finished island, or nullptr. Call MarkResident once it is uploaded.
+    std::unique_ptr<StreamedIsland> PopReady(const glm::vec2& cameraXZ);
+
+    void MarkResident(int cellId, size_t gpuBytes);
+
+    // The player took ring spawnIndex of a resident cell's island (RingSystem::LastCollected).
+    // Remembered by cell position until Reset, so the ring stays gone when the cell comes back.
+    void MarkCollected(int cellId, int spawnIndex);
+
+    // Resident cells whose islands should be freed now: all past streamDropRadius, then the
+    // farthest outside streamLoadRadius while resident GPU memory is over streamGpuBudgetMB.
+    // They are forgotten here (and generated again if the camera comes back).
+    void Evictions(const glm::vec2& cameraXZ, std::vector<int>& outCellIds);
+
+    const StreamCounters& Counters() const { return counters; }
+
+private:
+    enum class CellState { Generating, Ready, Sea, Resident };
+
+    struct Cell
+    {
+        int id = 0;
+        int x = 0, z = 0;
+        CellState state = CellState::Generating;
+        std::unique_ptr<StreamedIsland> result;   // filled by the job; null once handed over
+        std::future<bool> job;
+        size_t gpuBytes = 0;
+    };
+
+    std::unique_ptr<WorldGenerator> gen;
+    int seed = 0;
+    int nextId = 1;
+    std::unordered_map<uint64_t, Cell> cells;
+    std::unordered_map<uint64_t, std::vector<uint8_t>> collectedRings;   // by Key; flag per spawn index
+    StreamCounters counters;
+
+    static uint64_t Key(int x, int z) { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)z; }
+
+    void CellOf(const glm::vec2& p, int& x, int& z) const;
+    float CellDistance2(const Cell& c, const glm::vec2& p) const;
+    int CellRing(const Cell& c, int camX, int camZ) const;
+
+    void CollectFinished();
+    void Recount();
+};
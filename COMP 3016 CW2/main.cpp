@@ -9,7 +9,22 @@
 #include <sstream>
 #include <unordered_map>
 #include <string>
+#include <chrono>
+#include <future>
+#include <cstdint>
 #include "RingSystem.h"
+#include "JobPool.h"
+#include "Noise.h"
+#include "TerrainCache.h"
+#include "TerrainNormals.h"
+#include "MeshTypes.h"
+#include "WorldConfig.h"
+#include "Terrain.h"
+#include "WorldGen.h"
+#include "IslandIndex.h"
+#include "WorldStreamer.h"
+#include "Frustum.h"
+#include "TreeImpostor.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stbImage/stb_image.h"
 
@@ -17,6 +32,7 @@
 #include <GLFW/glfw3.h>
 
 #include "Shader.h"
+#include "FrameUniforms.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -35,105 +51,6 @@ using namespace irrklang;
 
 
 
-struct WorldConfig
-{
-    float oceanHalfSize = 600.0f;
-
-    int islandCount = 7;
-    float islandSpawnRadius = 420.0f;
-    float islandMinSpacing = 160.0f;
-
-    // Terrain
-    int terrainGrid = 250;
-    float terrainSpacing = 0.4f;
-    float seaLevel = 2.5f;
-
-    // Water
-    float waterSpacing = 1.0f;
-    float waveStrength = 1.2f;
-    float waveSpeed = 1.0f;
-
-    // Rendering / atmosphere
-    bool fogEnabled = true;
-    float fogDensity = 0.028f;
-    glm::vec3 fogColor = glm::vec3(0.02f, 0.03f, 0.06f);
-
-    // Day/Night Speed
-    float timeSpeed = 0.05f;
-
-    // PCG seed
-    int seed = 1337;
-
-    // Storm mode
-    bool stormMode = false;
-    float stormFogMultiplier = 2.5f;
-    float stormWaveMultiplier = 1.8f;
-
-    // Lighthouse placement / lighting
-    float lighthouseChancePerIsland = 0.55f; // 0..1
-    float lighthouseScale = 2.70f;
-    float lighthouseLanternHeight = 10.0f;  
-    float lighthouseLightStrength = 25.0f;    // brightness multiplier at full night
-
-    // Lighthouse beam tuning
-    float lighthouseBeamSpinSpeed = 0.35f;  // radians/sec
-    float lighthouseBeamLength = 40.0f;  // used as a scale multiplier 
-    float lighthouseBeamRadius = 6.0f;  // used as a scale multiplier 
-    float lighthouseBeamStrength = 6.5f;  // brightness of the visible cone
-
-
-};
-
-enum class IslandBiome : int
-{
-    Forest = 0,
-    Grassland = 1,
-    Snow = 2,
-    Desert = 3,
-    Village = 4
-};
-
-static const char* IslandBiomeName(IslandBiome b)
-{
-    switch (b)
-    {
-    case IslandBiome::Forest: return "Forest";
-    case IslandBiome::Grassland: return "Grassland";
-    case IslandBiome::Snow: return "Snow";
-    case IslandBiome::Desert: return "Desert";
-    case IslandBiome::Village: return "Village";
-    default: return "Unknown";
-    }
-}
-
-
-
-struct Vertex
-{
-    glm::vec3 pos;
-    glm::vec3 normal;
-    float moisture = 0.0f;
-    glm::vec2 uv;                
-};
-
-struct GLMesh
-{
-    GLuint vao = 0, vbo = 0, ebo = 0;
-    GLsizei indexCount = 0;
-    GLenum indexType = GL_UNSIGNED_INT;
-
-    void Destroy()
-    {
-        if (ebo) glDeleteBuffers(1, &ebo);
-        if (vbo) glDeleteBuffers(1, &vbo);
-        if (vao) glDeleteVertexArrays(1, &vao);
-        vao = vbo = ebo = 0;
-        indexCount = 0;
-    }
-
-    void Bind() const { glBindVertexArray(vao); }
-};
-
 struct PrintThrottle
 {
     float accum = 0.0f;
@@ -278,52 +195,6 @@ static float NightFactor(float t01)
     return glm::clamp(nf, 0.0f, 1.0f);
 }
 
-//  NOISE 
-
-static float hash2D(int x, int z, int seed)
-{
-    int h = x * 374761393 + z * 668265263 + seed * 1442695041;
-    h = (h ^ (h >> 13)) * 1274126177;
-    h ^= (h >> 16);
-    return (h & 0x00FFFFFF) / 16777215.0f;
-}
-
-static float smooth(float t) { return t * t * (3.0f - 2.0f * t); }
-static float lerp(float a, float b, float t) { return a + (b - a) * t; }
-
-static float valueNoise2D(float x, float z, int seed)
-{
-    int x0 = (int)floor(x);
-    int z0 = (int)floor(z);
-    int x1 = x0 + 1;
-    int z1 = z0 + 1;
-
-    float sx = smooth(x - x0);
-    float sz = smooth(z - z0);
-
-    float n00 = hash2D(x0, z0, seed);
-    float n10 = hash2D(x1, z0, seed);
-    float n01 = hash2D(x0, z1, seed);
-    float n11 = hash2D(x1, z1, seed);
-
-    return lerp(lerp(n00, n10, sx), lerp(n01, n11, sx), sz);
-}
-
-static float fbm(float x, float z, int seed, int octaves = 6, float lacunarity = 2.0f, float gain = 0.5f)
-{
-    float amp = 0.5f;
-    float freq = 1.0f;
-    float sum = 0.0f;
-
-    for (int i = 0; i < octaves; i++)
-    {
-        sum += amp * valueNoise2D(x * freq, z * freq, seed + i * 31);
-        freq *= lacunarity;
-        amp *= gain;
-    }
-    return sum;
-}
-
 // Hard coded tree pallet
 
 static GLuint CreateTreePaletteTexture_3x3()
@@ -352,471 +223,153 @@ static GLuint CreateTreePaletteTexture_3x3()
     return tex;
 }
 
-//  Terrain 
+// Water
 
-class Terrain
+// Per-draw and per-material uniforms of the scene shaders, as handles (Shader.h); everything shared
+// comes from the FrameData / SceneData blocks (FrameUniforms.h). One instance per shader; names a
+// shader lacks just resolve to -1.
+struct SceneUniforms
 {
-public:
-    float seaLevel = 2.5f;
-    float globalVerticalMul = 3.0f;
-
-    float HalfSize() const { return gridSize * spacing * 0.5f; }
-
-    const std::vector<Vertex>& Verts() const { return verts; }
-    float MaxHeight() const { return maxHeight; }
-    float Spacing() const { return spacing; }
-
-    glm::vec3 SampleNormalAtWorldXZ(float worldX, float worldZ) const
-    {
-        int idx = SampleIndex(worldX, worldZ);
-        return verts[idx].normal;
-    }
-
-    float SampleHeightAtWorldXZ(float worldX, float worldZ) const
-    {
-        float half = gridSize * spacing * 0.5f;
-
-        float gx = (worldX + half) / spacing;
-        float gz = (worldZ + half) / spacing;
-
-        gx = glm::clamp(gx, 0.0f, (float)gridSize - 0.0001f);
-        gz = glm::clamp(gz, 0.0f, (float)gridSize - 0.0001f);
-
-        int x0 = (int)floor(gx);
-        int z0 = (int)floor(gz);
-
-        float tx = gx - x0;
-        float tz = gz - z0;
-
-        int row0 = z0 * (gridSize + 1);
-        int row1 = (z0 + 1) * (gridSize + 1);
-
-        const Vertex& v00 = verts[row0 + x0];
-        const Vertex& v10 = verts[row0 + (x0 + 1)];
-        const Vertex& v01 = verts[row1 + x0];
-        const Vertex& v11 = verts[row1 + (x0 + 1)];
-
-        float h = 0.0f;
-
-        if (tx + tz <= 1.0f)
-        {
-            float w00 = 1.0f - tx - tz;
-            float w01 = tz;
-            float w10 = tx;
-            h = w00 * v00.pos.y + w01 * v01.pos.y + w10 * v10.pos.y;
-        }
-        else
-        {
-            float w11 = tx + tz - 1.0f;
-            float w10 = 1.0f - tz;
-            float w01 = 1.0f - tx;
-            h = w10 * v10.pos.y + w01 * v01.pos.y + w11 * v11.pos.y;
-        }
+    Uniform<float> additiveOnly{ "uAdditiveOnly" };
+    Uniform<int> albedoAtlas{ "uAlbedoAtlas" };
+    Uniform<float> alpha{ "uAlpha" };
+    Uniform<float> ambientStrength{ "uAmbientStrength" };
+    Uniform<float> beamStrength{ "uBeamStrength" };
+    Uniform<float> clipHalfCells{ "uClipHalfCells" };
+    Uniform<glm::vec2> clipOrigin{ "uClipOrigin" };
+    Uniform<float> clipSpacing{ "uClipSpacing" };
+    Uniform<float> debugWire{ "uDebugWire" };
+    Uniform<int> frames{ "uFrames" };
+    Uniform<glm::vec4> frustumPlanes{ "uFrustumPlanes" };
+    Uniform<glm::vec2> impostorFade{ "uImpostorFade" };
+    Uniform<int> lightIndex{ "uLightIndex" };
+    Uniform<glm::vec4> lodDistances{ "uLodDistances" };
+    Uniform<glm::mat4> model{ "uModel" };
+    Uniform<glm::vec2> morphRange{ "uMorphRange" };
+    Uniform<int> normalAtlas{ "uNormalAtlas" };
+    Uniform<int> ringTex{ "uRingTex" };
+    Uniform<float> shininess{ "uShininess" };
+    Uniform<float> specStrength{ "uSpecStrength" };
+    Uniform<int> tex{ "uTex" };
+    Uniform<int> texGrass{ "uTexGrass" };
+    Uniform<int> texRock{ "uTexRock" };
+    Uniform<int> texSand{ "uTexSand" };
+    Uniform<int> texSnow{ "uTexSnow" };
+    Uniform<float> texTiling{ "uTexTiling" };
+    Uniform<float> treeMaxY{ "uTreeMaxY" };
+    Uniform<float> treeMinY{ "uTreeMinY" };
+    Uniform<glm::vec4> treeSphere{ "uTreeSphere" };
+    Uniform<float> trunkFrac{ "uTrunkFrac" };
+    Uniform<float> useTextures{ "uUseTextures" };
+    Uniform<float> waterHeight{ "uWaterHeight" };
+};
 
-        return h;
-    }
-     
-    float SampleMoistureAtWorldXZ(float worldX, float worldZ) const
-    {
-        int idx = SampleIndex(worldX, worldZ);
-        return verts[idx].moisture;
-    }
+// Camera-centred ocean clipmap: nested squares of 2n x 2n cells, level L with spacing
+// spacing * 2^L. Level 0 is whole; every other level is a ring around the one inside it. A level
+// snaps to twice its own spacing, so the level inside sits 0 or 1 cells off its centre per axis and
+// the ring leaves out the matching hole (one index range per offset). There is no vertex buffer:
+// water.vert places the (2n + 1)^2 grid from gl_VertexID, and odd vertices morph onto their even
+// neighbours towards a level's edge, so they meet the coarser level around it without cracks.
+class Water
+{
+public:
+    float y = 2.5f;
+    SceneUniforms uniforms;    // of the shader passed to Draw
 
-    void Build(int gridSize, float spacing, int seed, IslandBiome islandBiome)
+    // halfCells is n (made even, 16..126 so indices fit 16 bits); levels are added until they
+    // reach halfSize. Depends on nothing else, so the world can be regenerated without touching it.
+    void Build(float halfSize, float spacing, int halfCells)
     {
-        this->gridSize = gridSize;
-        this->spacing = spacing;
-        this->seed = seed;
-
-        float half = gridSize * spacing * 0.5f;
-
-        verts.clear();
-        indices.clear();
-
-        verts.reserve((gridSize + 1) * (gridSize + 1));
-        indices.reserve(gridSize * gridSize * 6);
+        n = glm::clamp(halfCells + (halfCells & 1), 16, 126);
+        baseSpacing = spacing;
+        levels = 1;
+        while (n * baseSpacing * (float)(1 << (levels - 1)) < halfSize && levels < 16) levels++;
 
-        maxHeight = -1e9f;
+        const int side = 2 * n + 1;
+        std::vector<GLushort> idx;
+        idx.reserve((size_t)(4 * n * n + 4 * 3 * n * n) * 6);
 
-        float globalHeightScale = 0.65f;
-        float heightMul = 1.0f;
-        float ridgeMul = 1.0f;
-        float moistureMul = 1.0f;
-        float baseLift = 0.0f;
-
-        switch (islandBiome)
+        // range 0: the whole square; range 1 + ox + 2 * oz: the ring around a level offset by (ox, oz)
+        for (int range = 0; range < 5; range++)
         {
-        case IslandBiome::Forest:
-            moistureMul = 1.25f;
-            break;
-        case IslandBiome::Grassland:
-            moistureMul = 1.05f;
-            heightMul = 0.95f;
-            break;
-        case IslandBiome::Snow:
-            heightMul = 1.35f;
-            ridgeMul = 1.25f;
-            moistureMul = 0.90f;
-            baseLift = 0.2f;
-            break;
-        case IslandBiome::Desert:
-            heightMul = 0.85f;
-            ridgeMul = 0.60f;
-            moistureMul = 0.40f;
-            break;
-        case IslandBiome::Village:
-            // Flatter terrain with moderate moisture (good for grass + town)
-            heightMul = 0.80f;
-            ridgeMul = 0.55f;
-            moistureMul = 0.95f;
-            baseLift = 0.10f;
-            break;
-        }
+            rangeFirst[range] = (GLsizei)idx.size();
+            const int ox = (range - 1) & 1, oz = (range - 1) >> 1;
 
-        for (int z = 0; z <= gridSize; z++)
-        {
-            for (int x = 0; x <= gridSize; x++)
+            for (int z = -n; z < n; z++)
             {
-                float wx = x * spacing - half;
-                float wz = z * spacing - half;
-
-                float ax = fabs(wx);
-                float az = fabs(wz);
-
-                float t = glm::clamp(glm::max(ax, az) / half, 0.0f, 1.0f);
-
-                float mask = 1.0f - glm::smoothstep(0.0f, 1.0f, t);
-                mask = pow(mask, 0.2f);
-
-                float nBig = fbm(wx * 0.012f, wz * 0.012f, seed + 1000) * 2.0f - 1.0f;
-                float nMid = fbm(wx * 0.045f, wz * 0.045f, seed + 2000) * 2.0f - 1.0f;
-                float nSmall = fbm(wx * 0.160f, wz * 0.160f, seed + 3000) * 2.0f - 1.0f;
-
-                float ridge = 1.0f - fabs(nMid);
-                ridge = ridge * ridge;
-
-                float height =
-                    (nBig * 5.0f * heightMul) +
-                    (nMid * 3.5f * heightMul) +
-                    (ridge * 4.5f * ridgeMul) +
-                    (nSmall * 0.9f * heightMul);
-
-                height *= globalHeightScale * globalVerticalMul;
-                height += (4.2f + baseLift) * mask * globalVerticalMul;
-
-                float land = seaLevel + (height - seaLevel) * mask;
-
-                float coastStart = 0.05f;
-                float coast = glm::smoothstep(coastStart, 1.0f, t);
-                land = glm::mix(land, seaLevel, coast);
-
-                float rim = glm::smoothstep(0.88f, 1.0f, t);
-                land = glm::mix(land, seaLevel, rim);
-
-                float m = fbm(wx * 0.035f, wz * 0.035f, seed + 7777);
-                float altitude01 = glm::clamp((land - seaLevel) / 10.0f, 0.0f, 1.0f);
-                m = glm::mix(m, m * 0.6f, altitude01);
-
-                m *= moistureMul;
-                m = glm::clamp(m, 0.0f, 1.0f);
-
-				// Village biome gets a flattened area in the center
-                if (islandBiome == IslandBiome::Village)
+                for (int x = -n; x < n; x++)
                 {
-                    float r01 = glm::clamp(glm::length(glm::vec2(wx, wz)) / half, 0.0f, 1.0f);
+                    bool inHole = range > 0 && x >= ox - n / 2 && x < ox + n / 2 && z >= oz - n / 2 && z < oz + n / 2;
+                    if (inHole) continue;
 
-                    float flatMask = 1.0f - glm::smoothstep(0.75f, 0.92f, r01);
+                    GLushort i0 = (GLushort)((z + n) * side + (x + n));
+                    GLushort i1 = (GLushort)(i0 + side);
+                    GLushort i2 = (GLushort)(i0 + 1);
+                    GLushort i3 = (GLushort)(i1 + 1);
 
-                    float target = seaLevel + 2.2f;
-
-                    // allow a tiny bit of variation
-                    float micro = (fbm(wx * 0.08f, wz * 0.08f, seed + 4242) - 0.5f) * 0.25f;
-
-                    land = glm::mix(land, target + micro, flatMask * 0.95f);
+                    idx.push_back(i0); idx.push_back(i1); idx.push_back(i2);
+                    idx.push_back(i2); idx.push_back(i1); idx.push_back(i3);
                 }
-
-                Vertex v;
-                v.pos = glm::vec3(wx, land, wz);
-                v.normal = glm::vec3(0, 1, 0);
-                v.moisture = m;
-
-                const float uvScale = 0.05f;              
-                v.uv = glm::vec2(wx, wz) * uvScale;
-
-                verts.push_back(v);
-                maxHeight = std::max(maxHeight, land);
-            }
-        }
-
-        for (int z = 0; z < gridSize; z++)
-        {
-            for (int x = 0; x < gridSize; x++)
-            {
-                int r1 = z * (gridSize + 1);
-                int r2 = (z + 1) * (gridSize + 1);
-
-                unsigned int i0 = (unsigned int)(r1 + x);
-                unsigned int i1 = (unsigned int)(r2 + x);
-                unsigned int i2 = (unsigned int)(r1 + x + 1);
-                unsigned int i3 = (unsigned int)(r2 + x + 1);
-
-                indices.push_back(i0); indices.push_back(i1); indices.push_back(i2);
-                indices.push_back(i2); indices.push_back(i1); indices.push_back(i3);
             }
+            rangeCount[range] = (GLsizei)idx.size() - rangeFirst[range];
         }
 
-        ComputeNormals();
-        Upload();
+        Upload(idx);
     }
 
-    void Draw(Shader& shader,
-        const glm::mat4& model,
-        const glm::mat4& view,
-        const glm::mat4& proj,
-        const Camera& cam,
-        const glm::vec3& lightDir,
-        const glm::vec3& lightCol,
-        bool fogEnabled,
-        const glm::vec3& fogColor,
-        float fogDensity,
-        float islandBiomeId,
-        float islandSeed,
-       
-        const glm::vec3& lhPosWS,
-        const glm::vec3& lhCol,
-        float lhIntensity,
-        const glm::vec3& beamDirWS,
-        float beamInnerCos,
-        float beamOuterCos,
-        float beamRange)
+    int Levels() const { return levels; }
+    int VerticesPerPass() const { return levels * (2 * n + 1) * (2 * n + 1); }
+    int TrianglesPerPass() const { return (rangeCount[0] + (levels - 1) * rangeCount[1]) / 3; }
+
+    // Lighting constants; once per frame, before the Draw calls
+    void SetMaterial(Shader& shader)
     {
         shader.Use();
-        shader.SetMat4("uModel", glm::value_ptr(model));
-        shader.SetMat4("uView", glm::value_ptr(view));
-        shader.SetMat4("uProj", glm::value_ptr(proj));
-
-        shader.SetVec3("uViewPos", cam.pos.x, cam.pos.y, cam.pos.z);
-        shader.SetVec3("uLightDir", lightDir.x, lightDir.y, lightDir.z);
-        shader.SetVec3("uLightColor", lightCol.x, lightCol.y, lightCol.z);
-
-        shader.SetFloat("uAmbientStrength", 0.20f);
-        shader.SetFloat("uSpecStrength", 0.35f);
-        shader.SetFloat("uShininess", 32.0f);
-
-        shader.SetFloat("uSeaLevel", seaLevel);
-
-        shader.SetFloat("uFogEnabled", fogEnabled ? 1.0f : 0.0f);
-        shader.SetVec3("uFogColor", fogColor.x, fogColor.y, fogColor.z);
-        shader.SetFloat("uFogDensity", fogDensity);
-
-        shader.SetFloat("uIslandBiome", islandBiomeId);
-        shader.SetFloat("uIslandSeed", islandSeed);
-
-        // lighthouse point light uniforms for terrain
-        shader.SetVec3("uPointLightPos", lhPosWS.x, lhPosWS.y, lhPosWS.z);
-        shader.SetVec3("uPointLightColor", lhCol.x, lhCol.y, lhCol.z);
-        shader.SetFloat("uPointLightIntensity", lhIntensity);
-        shader.SetVec3("uBeamDir", beamDirWS.x, beamDirWS.y, beamDirWS.z);
-        shader.SetFloat("uBeamInnerCos", beamInnerCos);
-        shader.SetFloat("uBeamOuterCos", beamOuterCos);
-        shader.SetFloat("uBeamRange", beamRange);
-
-     
-
-        mesh.Bind();
-        glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+        shader.Set(uniforms.ambientStrength, 0.25f);
+        shader.Set(uniforms.specStrength, 0.6f);
+        shader.Set(uniforms.shininess, 128.0f);
     }
 
-    void Destroy()
+    // Every level around viewPos. Sun, waves and fog come from the uniform blocks; the pass (base
+    // or one lantern) is whatever uAdditiveOnly / uLightIndex the caller left set.
+    void Draw(Shader& shader, const glm::vec3& viewPos)
     {
-        mesh.Destroy();
-    }
-
-private:
-    int gridSize = 0;
-    float spacing = 0.0f;
-    int seed = 0;
-
-    std::vector<Vertex> verts;
-    std::vector<unsigned int> indices;
+        if (mesh.vao == 0) return;
 
-    GLMesh mesh;
-    float maxHeight = 0.0f;
-
-    void ComputeNormals()
-    {
-        for (auto& v : verts) v.normal = glm::vec3(0);
+        shader.Use();
+        shader.Set(uniforms.waterHeight, y);
+        shader.Set(uniforms.clipHalfCells, (float)n);
 
-        for (size_t i = 0; i < indices.size(); i += 3)
+        const glm::vec2 cam(viewPos.x, viewPos.z);
+        mesh.Bind();
+        for (int l = 0; l < levels; l++)
         {
-            auto& a = verts[indices[i]];
-            auto& b = verts[indices[i + 1]];
-            auto& c = verts[indices[i + 2]];
-            glm::vec3 n = glm::normalize(glm::cross(b.pos - a.pos, c.pos - a.pos));
-            a.normal += n; b.normal += n; c.normal += n;
-        }
-
-        for (auto& v : verts) v.normal = glm::normalize(v.normal);
-    }
-
-    int SampleIndex(float worldX, float worldZ) const
-    {
-        float half = gridSize * spacing * 0.5f;
-        int gx = (int)floor((worldX + half) / spacing);
-        int gz = (int)floor((worldZ + half) / spacing);
-
-        gx = glm::clamp(gx, 0, gridSize);
-        gz = glm::clamp(gz, 0, gridSize);
-
-        return gz * (gridSize + 1) + gx;
-    }
-
-    void Upload()
-    {
-        mesh.Destroy();
-
-        glGenVertexArrays(1, &mesh.vao);
-        glGenBuffers(1, &mesh.vbo);
-        glGenBuffers(1, &mesh.ebo);
-
-        glBindVertexArray(mesh.vao);
-
-        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-        glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(Vertex), verts.data(), GL_STATIC_DRAW);
+            const float s = baseSpacing * (float)(1 << l);
+            const glm::vec2 origin = glm::floor(cam / (2.0f * s)) * (2.0f * s);
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-        glEnableVertexAttribArray(0);
-
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-        glEnableVertexAttribArray(1);
-
-        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, moisture));
-        glEnableVertexAttribArray(2);
-        
-        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
-        glEnableVertexAttribArray(3);
-
-
-        glBindVertexArray(0);
-
-        mesh.indexCount = (GLsizei)indices.size();
-    }
-};
-
-// Water
-
-class Water
-{
-public:
-    float y = 2.5f;
-
-    void BuildFromWorldSize(float halfSize, float spacing)
-    {
-        int grid = (int)std::ceil((halfSize * 2.0f) / spacing);
-        Build(grid, spacing);
-    }
-
-    void Build(int grid, float spacing)
-    {
-        std::vector<Vertex> verts;
-        std::vector<unsigned int> idx;
-        float half = grid * spacing * 0.5f;
-
-        verts.reserve((grid + 1) * (grid + 1));
-        idx.reserve(grid * grid * 6);
-        for (int z = 0; z <= grid; z++)
-        {
-            for (int x = 0; x <= grid; x++)
+            int range = 0;
+            if (l > 0)
             {
-                Vertex vv;
-                vv.pos = glm::vec3(x * spacing - half, y, z * spacing - half);
-                vv.normal = glm::vec3(0.0f, 1.0f, 0.0f);
-                vv.moisture = 0.0f;
-                vv.uv = glm::vec2((float)x, (float)z) * 0.05f; // harmless if water shader ignores
-                verts.push_back(vv);
+                glm::vec2 inner = glm::floor(cam / s) * s;
+                glm::ivec2 o = glm::ivec2(glm::round((inner - origin) / s));
+                range = 1 + o.x + 2 * o.y;
             }
-        }
-
 
-        for (int z = 0; z < grid; z++)
-        {
-            for (int x = 0; x < grid; x++)
+            // the camera is at least n - 2 cells from the level's edge, so the edge is always fully
+            // morphed; the outermost level has nothing to meet
+            float morphStart = 1e30f, morphInv = 0.0f;
+            if (l < levels - 1)
             {
-                int r1 = z * (grid + 1);
-                int r2 = (z + 1) * (grid + 1);
-
-                unsigned int i0 = (unsigned int)(r1 + x);
-                unsigned int i1 = (unsigned int)(r2 + x);
-                unsigned int i2 = (unsigned int)(r1 + x + 1);
-                unsigned int i3 = (unsigned int)(r2 + x + 1);
-
-                idx.push_back(i0); idx.push_back(i1); idx.push_back(i2);
-                idx.push_back(i2); idx.push_back(i1); idx.push_back(i3);
+                float morphEnd = (float)(n - 2) * s;
+                morphStart = morphEnd - (float)(n / 4) * s;
+                morphInv = 1.0f / (morphEnd - morphStart);
             }
-        }
-
-        Upload(verts, idx);
-    }
-
-    void Draw(Shader& shader,
-        const glm::mat4& model,
-        const glm::mat4& view,
-        const glm::mat4& proj,
-        const Camera& cam,
-        const glm::vec3& lightDir,
-        const glm::vec3& lightCol,
-        float timeSeconds,
-        float waveStrength,
-        float waveSpeed,
-        bool fogEnabled,
-        const glm::vec3& fogColor,
-        float fogDensity,
-        const glm::vec3& lhPosWS,
-        const glm::vec3& lhCol,
-        float lhIntensity,
-        const glm::vec3& beamDirWS,
-        float beamInnerCos,
-        float beamOuterCos,
-        float beamRange) 
-
-
-    {
-        shader.Use();
-        shader.SetMat4("uModel", glm::value_ptr(model));
-        shader.SetMat4("uView", glm::value_ptr(view));
-        shader.SetMat4("uProj", glm::value_ptr(proj));
-
-        shader.SetFloat("uTime", timeSeconds);
-        shader.SetFloat("uWaveStrength", waveStrength);
-        shader.SetFloat("uWaveSpeed", waveSpeed);
-
-        shader.SetVec3("uViewPos", cam.pos.x, cam.pos.y, cam.pos.z);
-        shader.SetVec3("uLightDir", lightDir.x, lightDir.y, lightDir.z);
-        shader.SetVec3("uLightColor", lightCol.x, lightCol.y, lightCol.z);
-
-        shader.SetFloat("uAmbientStrength", 0.25f);
-        shader.SetFloat("uSpecStrength", 0.6f);
-        shader.SetFloat("uShininess", 128.0f);
 
-        shader.SetFloat("uFogEnabled", fogEnabled ? 1.0f : 0.0f);
-        shader.SetVec3("uFogColor", fogColor.x, fogColor.y, fogColor.z);
-        shader.SetFloat("uFogDensity", fogDensity); 
-
-       
-        shader.SetVec3("uPointLightPos", lhPosWS.x, lhPosWS.y, lhPosWS.z);
-        shader.SetVec3("uPointLightColor", lhCol.x, lhCol.y, lhCol.z);
-        shader.SetFloat("uPointLightIntensity", lhIntensity);
-        shader.SetVec3("uBeamDir", beamDirWS.x, beamDirWS.y, beamDirWS.z);
-        shader.SetFloat("uBeamInnerCos", beamInnerCos);
-        shader.SetFloat("uBeamOuterCos", beamOuterCos);
-        shader.SetFloat("uBeamRange", beamRange);
-
-        mesh.Bind();
-        glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0);
+            shader.Set(uniforms.clipOrigin, origin);
+            shader.Set(uniforms.clipSpacing, s);
+            shader.Set(uniforms.morphRange, glm::vec2(morphStart, morphInv));
+            glDrawElements(GL_TRIANGLES, rangeCount[range], GL_UNSIGNED_SHORT, (void*)((size_t)rangeFirst[range] * sizeof(GLushort)));
+        }
         glBindVertexArray(0);
     }
 
@@ -827,32 +380,26 @@ public:
 
 private:
     GLMesh mesh;
+    int n = 0;
+    int levels = 0;
+    float baseSpacing = 1.0f;
+    GLsizei rangeFirst[5] = {};
+    GLsizei rangeCount[5] = {};
 
-    void Upload(const std::vector<Vertex>& verts, const std::vector<unsigned int>& idx)
+    void Upload(const std::vector<GLushort>& idx)
     {
         mesh.Destroy();
 
         glGenVertexArrays(1, &mesh.vao);
-        glGenBuffers(1, &mesh.vbo);
         glGenBuffers(1, &mesh.ebo);
 
         glBindVertexArray(mesh.vao);
-
-        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-        glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(Vertex), verts.data(), GL_STATIC_DRAW);
-
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx.size() * sizeof(unsigned int), idx.data(), GL_STATIC_DRAW);
-
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-        glEnableVertexAttribArray(0);
-
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-        glEnableVertexAttribArray(1);
-
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx.size() * sizeof(GLushort), idx.data(), GL_STATIC_DRAW);
         glBindVertexArray(0);
 
         mesh.indexCount = (GLsizei)idx.size();
+        mesh.indexType = GL_UNSIGNED_SHORT;
     }
 };
 
@@ -885,18 +432,13 @@ public:
         glBindVertexArray(0);
     }
 
-    void Draw(Shader& shader, const glm::mat4& view, const glm::mat4& proj, const glm::vec3& sunDir, float time01)
+    // View, sun and time of day come from the FrameData block; sky.vert drops the translation
+    void Draw(Shader& shader)
     {
         glDepthFunc(GL_LEQUAL);
         glDepthMask(GL_FALSE);
 
-        glm::mat4 skyView = glm::mat4(glm::mat3(view));
-
         shader.Use();
-        shader.SetMat4("uView", glm::value_ptr(skyView));
-        shader.SetMat4("uProj", glm::value_ptr(proj));
-        shader.SetVec3("uSunDir", sunDir.x, sunDir.y, sunDir.z);
-        shader.SetFloat("uTime01", time01);
 
         glBindVertexArray(vao);
         glDrawArrays(GL_TRIANGLES, 0, 36);
@@ -919,21 +461,8 @@ private:
 
 //  OBJ / Assimp Model
 
-struct PlacedHouse
-{
-    glm::mat4 model = glm::mat4(1.0f);
-    int variant = 0;
-};
-
 //  OBJ Model
 
-struct ModelVertex
-{
-    glm::vec3 pos;
-    glm::vec3 normal;
-    glm::vec2 uv;
-};
-
 static bool LoadOBJ_Minimal(const std::string& path,
     std::vector<ModelVertex>& outVerts,
     std::vector<unsigned int>& outIdx)
@@ -1191,6 +720,7 @@ static bool LoadModelAny_FirstMesh(
 struct GLModel
 {
     GLMesh mesh;
+    Aabb bounds;       // model space
 
     void Destroy() { mesh.Destroy(); }
 
@@ -1223,219 +753,107 @@ struct GLModel
 
         mesh.indexCount = (GLsizei)idx.size();
         mesh.indexType = GL_UNSIGNED_INT;
+
+        bounds = Aabb();
+        for (const auto& v : verts) bounds.Add(v.pos);
     }
 };
 
-//  Tree System 
-
-class TreeSystem
+static void BuildConeModel(GLModel& out, float height, float radius, int sides)
 {
-public:
-    void InitForMesh(const GLMesh& mesh)
-    {
-        if (vao == 0) glGenVertexArrays(1, &vao);
-        if (instanceVBO == 0) glGenBuffers(1, &instanceVBO);
-
-        glBindVertexArray(vao);
+    std::vector<ModelVertex> v;
+    std::vector<unsigned int> idx;
 
-        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+    // tip at +Y, base at 0
+    ModelVertex tip{};
+    tip.pos = glm::vec3(0, height, 0);
+    tip.normal = glm::vec3(0, 1, 0);
+    tip.uv = glm::vec2(0, 0);
+    v.push_back(tip);
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)offsetof(ModelVertex, pos));
+    // base ring
+    for (int s = 0; s < sides; s++)
+    {
+        float a = (float)s / (float)sides * glm::two_pi<float>();
+        float x = cos(a) * radius;
+        float z = sin(a) * radius;
 
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)offsetof(ModelVertex, normal));
+        ModelVertex mv{};
+        mv.pos = glm::vec3(x, 0.0f, z);
 
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)offsetof(ModelVertex, uv));
-
-        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-
-        std::size_t vec4Size = sizeof(glm::vec4);
-
-        for (int i = 0; i < 4; i++)
-        {
-            glEnableVertexAttribArray(3 + i);
-            glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * vec4Size));
-            glVertexAttribDivisor(3 + i, 1);
-        }
-
-        glBindVertexArray(0);
+        // approximate normals pointing outwards
+        mv.normal = glm::normalize(glm::vec3(x, radius * 0.6f, z));
+        mv.uv = glm::vec2((float)s / (float)sides, 1.0f);
+        v.push_back(mv);
     }
 
-    void PlaceOnTerrain(const Terrain& terrain,
-        int seed,
-        const glm::vec3& worldOffset,
-        const glm::vec3& pivotMS)
+    // side triangles
+    for (int s = 0; s < sides; s++)
     {
-        instances.clear();
-        instances.reserve(2500);
-
-        const auto& verts = terrain.Verts();
-        float spacing = terrain.Spacing();
-
-        std::mt19937 rng(seed);
-        std::uniform_int_distribution<int> pick(0, (int)verts.size() - 1);
-
-        std::uniform_real_distribution<float> jitter(-spacing * 0.45f, spacing * 0.45f);
-        std::uniform_real_distribution<float> rotY(0.0f, glm::two_pi<float>());
-        std::uniform_real_distribution<float> scaleR(0.8f, 1.5f);
-        std::uniform_real_distribution<float> chance01(0.0f, 1.0f);
-
-        const float slopeLimit = 0.80f;
-        const float minMoisture = 0.45f;
-        const float minHeight = terrain.seaLevel + 0.12f;
-        const int desiredTrees = 800;
-        const int maxTries = desiredTrees * 8;
-
-        const float TREE_SHRINK = 0.30f;
-
-        for (int tries = 0; tries < maxTries && (int)instances.size() < desiredTrees; tries++)
-        {
-            int idx = pick(rng);
-
-            glm::vec3 local = verts[idx].pos;
-
-            local.x += jitter(rng);
-            local.z += jitter(rng);
-
-            float half = terrain.HalfSize();
-
-            if (local.x < -half || local.x > half || local.z < -half || local.z > half)
-                continue;
-
-            local.y = terrain.SampleHeightAtWorldXZ(local.x, local.z);
-
-            glm::vec3 n2 = terrain.SampleNormalAtWorldXZ(local.x, local.z);
-            float m2 = terrain.SampleMoistureAtWorldXZ(local.x, local.z);
-
-            if (local.y < minHeight) continue;
-            if (n2.y < slopeLimit) continue;
-            if (m2 < minMoisture) continue;
-
-            float prob = glm::clamp((m2 - minMoisture) / (1.0f - minMoisture), 0.0f, 1.0f);
-            prob *= prob;
-            if (chance01(rng) > prob) continue;
-
-            float s = scaleR(rng) * TREE_SHRINK;
-            float r = rotY(rng);
-
-            glm::vec3 world = local + worldOffset;
-
-            glm::mat4 T = glm::translate(glm::mat4(1.0f), world);
-            glm::mat4 Rm = glm::rotate(glm::mat4(1.0f), r, glm::vec3(0, 1, 0));
-            glm::mat4 Sm = glm::scale(glm::mat4(1.0f), glm::vec3(s));
-            glm::mat4 P = glm::translate(glm::mat4(1.0f), -pivotMS);
-
-            instances.push_back(T * Rm * Sm * P);
-        }
-
-        std::cout << "Trees placed: " << instances.size() << "\n";
+        int i0 = 0; // tip
+        int i1 = 1 + s;
+        int i2 = 1 + ((s + 1) % sides);
+        idx.push_back(i0);
+        idx.push_back(i1);
+        idx.push_back(i2);
     }
 
-    void UploadInstances()
-    {
-        if (instanceVBO == 0) return;
+    out.Upload(v, idx);
+}
 
-        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
-        glBufferData(GL_ARRAY_BUFFER,
-            instances.size() * sizeof(glm::mat4),
-            instances.empty() ? nullptr : instances.data(),
-            GL_DYNAMIC_DRAW);
-    }
+// LOD mesh by vertex clustering: vertices are merged per cell of a cells^3 grid over the mesh
+// (at their average position, keeping the first one's normal and uv) and collapsed triangles dropped
+static void SimplifyByClustering(const std::vector<ModelVertex>& v, const std::vector<unsigned int>& idx, int cells,
+    std::vector<ModelVertex>& outV, std::vector<unsigned int>& outIdx)
+{
+    outV.clear();
+    outIdx.clear();
+    if (v.empty() || cells < 1) return;
 
-    void DrawInstanced(GLsizei indexCount) const
+    glm::vec3 lo(1e30f), hi(-1e30f);
+    for (const auto& mv : v)
     {
-        if (instances.empty() || vao == 0) return;
-
-        glBindVertexArray(vao);
-        glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, (GLsizei)instances.size());
-        glBindVertexArray(0);
+        lo = glm::min(lo, mv.pos);
+        hi = glm::max(hi, mv.pos);
     }
+    glm::vec3 cellSize = glm::max((hi - lo) / (float)cells, glm::vec3(1e-6f));
 
-    void ClearInstances()
-    {
-        instances.clear();
-        UploadInstances();
-    }
+    std::unordered_map<uint64_t, unsigned int> cellVertex;
+    std::vector<glm::vec3> sum;
+    std::vector<int> count;
+    std::vector<unsigned int> remap(v.size());
 
-    void Destroy()
+    for (size_t i = 0; i < v.size(); i++)
     {
-        instances.clear();
+        glm::ivec3 c = glm::clamp(glm::ivec3((v[i].pos - lo) / cellSize), glm::ivec3(0), glm::ivec3(cells - 1));
+        uint64_t key = ((uint64_t)c.x * cells + (uint64_t)c.y) * cells + (uint64_t)c.z;
 
-        if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
-        instanceVBO = 0;
+        auto ins = cellVertex.try_emplace(key, (unsigned int)outV.size());
+        if (ins.second)
+        {
+            outV.push_back(v[i]);
+            sum.push_back(glm::vec3(0.0f));
+            count.push_back(0);
+        }
 
-        if (vao) glDeleteVertexArrays(1, &vao);
-        vao = 0;
+        unsigned int o = ins.first->second;
+        sum[o] += v[i].pos;
+        count[o]++;
+        remap[i] = o;
     }
 
-private:
-    GLuint vao = 0;
-    GLuint instanceVBO = 0;
-    std::vector<glm::mat4> instances;
-};
-
-//  Island 
-
-struct Island
-{
-    Terrain terrain;
-    TreeSystem trees;
-    glm::mat4 model = glm::mat4(1.0f);
-    glm::vec2 centerXZ = glm::vec2(0.0f);
-    int seed = 0;
-    IslandBiome biome = IslandBiome::Forest;
-    std::vector<PlacedHouse> houses;
-
-    // Lighthouse (one per island max)
-    bool hasLighthouse = false;
-    glm::vec3 lighthousePosWS{ 0.0f };
-    glm::mat4 lighthouseModel = glm::mat4(1.0f);
-};
-
-static void BuildConeModel(GLModel& out, float height, float radius, int sides)
-{
-    std::vector<ModelVertex> v;
-    std::vector<unsigned int> idx;
+    for (size_t o = 0; o < outV.size(); o++)
+        outV[o].pos = sum[o] / (float)count[o];
 
-    // tip at +Y, base at 0
-    ModelVertex tip{};
-    tip.pos = glm::vec3(0, height, 0);
-    tip.normal = glm::vec3(0, 1, 0);
-    tip.uv = glm::vec2(0, 0);
-    v.push_back(tip);
-
-    // base ring
-    for (int s = 0; s < sides; s++)
+    for (size_t t = 0; t + 2 < idx.size(); t += 3)
     {
-        float a = (float)s / (float)sides * glm::two_pi<float>();
-        float x = cos(a) * radius;
-        float z = sin(a) * radius;
+        unsigned int a = remap[idx[t]], b = remap[idx[t + 1]], c = remap[idx[t + 2]];
+        if (a == b || b == c || a == c) continue;
 
-        ModelVertex mv{};
-        mv.pos = glm::vec3(x, 0.0f, z);
-
-        // approximate normals pointing outwards
-        mv.normal = glm::normalize(glm::vec3(x, radius * 0.6f, z));
-        mv.uv = glm::vec2((float)s / (float)sides, 1.0f);
-        v.push_back(mv);
-    }
-
-    // side triangles
-    for (int s = 0; s < sides; s++)
-    {
-        int i0 = 0; // tip
-        int i1 = 1 + s;
-        int i2 = 1 + ((s + 1) % sides);
-        idx.push_back(i0);
-        idx.push_back(i1);
-        idx.push_back(i2);
+        outIdx.push_back(a);
+        outIdx.push_back(b);
+        outIdx.push_back(c);
     }
-
-    out.Upload(v, idx);
 }
 static GLuint LoadTexture2D(const char* path, bool srgb = false)
 {
@@ -1484,8 +902,6 @@ class App
     float treeModelMaxY = 1.0f;
     float treeTrunkMinY = 0.0f;
     glm::vec3 treePivotMS = glm::vec3(0.0f);
-    int   waterLightIdx = -1;
-    float waterLightDist = 1e30f;
     bool debugLH = false;          
     PrintThrottle lhPrint;
 
@@ -1556,11 +972,19 @@ public:
         skyShader = std::make_unique<Shader>("shaders/sky.vert", "shaders/sky.frag");
         waterShader = std::make_unique<Shader>("shaders/water.vert", "shaders/water.frag");
         treeShader = std::make_unique<Shader>("shaders/tree.vert", "shaders/tree.frag");
+        treeCullShader = std::make_unique<Shader>("shaders/tree_cull.vert", "shaders/tree_cull.geom",
+            std::vector<const char*>{ "oLod0", "gl_NextBuffer", "oLod1", "gl_NextBuffer", "oLod2" });
+        impostorShader = std::make_unique<Shader>("shaders/impostor.vert", "shaders/impostor.frag");
         lighthouseShader = std::make_unique<Shader>("shaders/lighthouse.vert", "shaders/lighthouse.frag");
         beamShader = std::make_unique<Shader>("shaders/beam.vert", "shaders/beam.frag");
         ringShader = std::make_unique<Shader>("shaders/ring.vert", "shaders/ring.frag"); 
+        ringCullShader = std::make_unique<Shader>("shaders/ring_cull.vert", "shaders/ring_cull.geom",
+            std::vector<const char*>{ "oPosWS", "oYawPitchScale" });
         hudShader = std::make_unique<Shader>("shaders/hud.vert", "shaders/hud.frag");
 
+        frameUbo.Create(kFrameDataBinding);
+        sceneUbo.Create(kSceneDataBinding);
+
         // Fullscreen quad in NDC (covers whole screen)
         float quad[] =
         {
@@ -1623,6 +1047,12 @@ public:
             {
                 treeModel.Upload(tv, ti);
                 treeModelLoaded = true;
+
+                std::vector<ModelVertex> lv;
+                std::vector<unsigned int> li;
+                SimplifyByClustering(tv, ti, cfg.treeLodClusterCells, lv, li);
+                if (!li.empty()) treeLodModel.Upload(lv, li);
+                std::cout << "Tree LOD: " << ti.size() / 3 << " -> " << li.size() / 3 << " triangles\n";
             }
 
             treeModelMinY = 1e9f;
@@ -1662,6 +1092,13 @@ public:
             std::cout << "Tree minY=" << treeModelMinY
                 << " trunkMinY=" << treeTrunkMinY
                 << " pivotMS=(" << treePivotMS.x << "," << treePivotMS.y << "," << treePivotMS.z << ")\n";
+
+            if (treeModelLoaded && cfg.treeImpostors)
+            {
+                treeImpostor.Bake(treeModel.mesh, treeModel.bounds, treeTrunkMinY, treeModelMaxY, kTreeTrunkFrac,
+                    cfg.treeImpostorFrames, cfg.treeImpostorFrameSize);
+                glViewport(0, 0, width, height);
+            }
         }
 
         // Load lighthouse OBJ
@@ -1766,7 +1203,18 @@ public:
         }
 
 
-RebuildWorld(cfg.seed);
+        if (cfg.terrainCacheEnabled)
+            terrainCache.Init(cfg.terrainCacheDir, (uint64_t)std::max(cfg.terrainCacheMaxMB, 0) << 20);
+
+        genPool = std::make_unique<JobPool>(cfg.genThreads);
+        std::cout << "World generation threads: " << genPool->ThreadCount() << "\n";
+
+        terrainLod.baseRange = cfg.terrainLodBaseRange;
+
+        if (cfg.streamingWorld)
+            StartStreaming(cfg.seed);
+        else
+            RebuildWorld(cfg.seed);
         tod.speed = cfg.timeSpeed;
 
         std::cout << "\nControls:\n"
@@ -1776,6 +1224,8 @@ RebuildWorld(cfg.seed);
             << "  P: toggle wireframe\n"
             << "  O: toggle storm mode\n"
             << "  B: toggle Beam (visible cone)\n"
+            << "  G: log world generation diagnostics (noise kernels, thread scaling, normals)\n"
+            << "  I: toggle render stats (printed once a second)\n"
             << "  ESC: quit\n\n";
 
 
@@ -1797,6 +1247,17 @@ RebuildWorld(cfg.seed);
 
             fpsTimer += dt;
             frameCount++;
+
+            if (staged) staged->worstFrameMs = std::max(staged->worstFrameMs, dt * 1000.0f);
+            if (cfg.streamingWorld)
+            {
+                PumpStreaming(cfg.regenUploadBudgetMs);
+            }
+            else if (PumpRebuild(cfg.regenUploadBudgetMs) && regenQueued)
+            {
+                regenQueued = false;
+                BeginRebuild(cfg.seed * 1664525 + 1013904223);
+            }
          
             HandleInteraction();
 
@@ -1812,15 +1273,23 @@ RebuildWorld(cfg.seed);
             float slope = 1.0f - glm::clamp(groundN.y, 0.0f, 1.0f);
             float speedMul = glm::clamp(1.0f - slope * 0.6f, 0.4f, 1.0f);
 
+            glm::vec3 prevCamPos = camera.pos;
             camera.ProcessKeyboard(window, dt, speedMul);
             tod.Update(dt);
 
-            int got = rings.UpdateCollect(camera.pos);
+            int got = rings.UpdateCollect(prevCamPos, camera.pos);
             if (got > 0 && audio)
             {
                 audio->play2D("assets/sfx/ring_collect.wav");
             }
 
+            // a streamed cell regenerates its rings when it comes back; the streamer keeps them collected
+            if (got > 0 && streamer.Active())
+            {
+                for (const RingSystem::CollectedRing& c : rings.LastCollected())
+                    streamer.MarkCollected(c.owner, c.spawnIndex);
+            }
+
             // update title when score changes (cheap “UI”)
             int score = rings.GetScore();
             if (score != lastDisplayedScore)
@@ -1840,14 +1309,22 @@ RebuildWorld(cfg.seed);
 
     void Shutdown()
     {
+        CancelRebuild();
+        streamer.Clear();
+        genPool.reset();
+        terrainPatch.Destroy();
+
         for (auto& isl : islands)
         {
             isl.trees.Destroy();
             isl.terrain.Destroy();
         }
         islands.clear();
+        terrainTextures.Destroy();
 
         treeModel.Destroy();
+        treeLodModel.Destroy();
+        treeImpostor.Destroy();
         lighthouseModel.Destroy();
         water.Destroy();
         sky.Destroy();
@@ -1855,11 +1332,17 @@ RebuildWorld(cfg.seed);
         if (treePaletteTex) glDeleteTextures(1, &treePaletteTex);
         treePaletteTex = 0;
 
+        frameUbo.Destroy();
+        sceneUbo.Destroy();
+
         ringShader.reset();
+        ringCullShader.reset();
         terrainShader.reset();
         skyShader.reset();
         waterShader.reset();
         treeShader.reset();
+        treeCullShader.reset();
+        impostorShader.reset();
         lighthouseShader.reset();
 
         if (texHelp) glDeleteTextures(1, &texHelp);
@@ -1928,6 +1411,81 @@ private:
     std::vector<Island> islands;
     WorldConfig cfg;
 
+    // Per-frame island lookups: island centres, and lantern positions of islands with a
+    // lighthouse (ids are indices into islands). Rebuilt when a world is swapped in.
+    IslandIndex islandIndex;
+    IslandIndex lighthouseIndex;
+    std::vector<int> nearbyLighthouses;
+
+    // View frustum of the current frame and the island boxes it is tested against (same order
+    // as islands, rebuilt with the index). islandVisible is refreshed at the top of Render.
+    Frustum frustum;
+    AabbList islandBoxes;
+    std::vector<uint8_t> islandVisible;
+    KeyLatch kCull, kTreeCull;
+
+    std::unique_ptr<JobPool> genPool;
+    TerrainCache terrainCache;
+
+    // Next world, generated in the background and uploaded over several frames before the swap
+    struct StagedWorld
+    {
+        int seed = 0;
+        std::vector<Island> islands;
+        RingSystem rings;              // ring data only, moved into `rings` on swap
+        int uploaded = 0;              // islands whose GL data is ready
+        double cpuMs = 0.0;
+        double uploadMs = 0.0;
+        int uploadFrames = 0;
+        float worstFrameMs = 0.0f;
+        std::chrono::steady_clock::time_point started;
+    };
+    std::unique_ptr<StagedWorld> staged;
+    std::future<void> stagedJob;       // valid while the CPU half is running
+    bool regenQueued = false;
+
+    // Streaming world (cfg.streamingWorld): islands arrive and leave one at a time with the
+    // camera instead of being staged as a whole world. islandCells[i] is the cell of islands[i].
+    WorldStreamer streamer;
+    std::vector<int> islandCells;
+    std::vector<int> evictedCells;
+
+    bool waterBuilt = false;
+    float waterBuiltHalfSize = 0.0f;
+    float waterBuiltSpacing = 0.0f;
+    int waterBuiltCells = 0;
+
+    TerrainPatchMesh terrainPatch;
+    TerrainTexturePool terrainTextures;   // island maps of the previous world, re-filled by the next
+    TerrainLodSettings terrainLod;
+
+    // Built on first use and again only if the patch size changes; shared by every island
+    const TerrainPatchMesh& TerrainPatch()
+    {
+        if (terrainPatch.quads != cfg.terrainLodPatchQuads)
+            terrainPatch.Build(cfg.terrainLodPatchQuads);
+        return terrainPatch;
+    }
+
+    // Per-frame render counters, reset at the top of Render
+    struct FrameStats
+    {
+        int terrainTriangles = 0;
+        int terrainNodes = 0;
+        int islandsVisible = 0, islandsCulled = 0;
+        int housesVisible = 0, housesCulled = 0;
+        int lighthousesVisible = 0, lighthousesCulled = 0;
+        int beamsVisible = 0, beamsCulled = 0;
+        int ringsVisible = 0, ringsCulled = 0;
+        int treesLod[TreeSystem::kLodCount] = {};   // a tree in the impostor crossfade counts twice
+        int treesTotal = 0;
+        long long treeTriangles = 0;
+    };
+    FrameStats frameStats;
+    KeyLatch kStats;
+    bool showStats = false;
+    PrintThrottle statsPrint;
+
     Camera camera;
     TimeOfDaySystem tod;
 
@@ -1937,10 +1495,29 @@ private:
     std::unique_ptr<Shader> terrainShader, skyShader, waterShader, treeShader;
     std::unique_ptr<Shader> lighthouseShader, beamShader;
     std::unique_ptr<Shader> ringShader;
+    std::unique_ptr<Shader> treeCullShader;    // transform feedback only
+    std::unique_ptr<Shader> ringCullShader;    // transform feedback only
+    std::unique_ptr<Shader> impostorShader;
+
+    // Uniform handles of the shaders above, set from Render (houses use lighthouseShader)
+    SceneUniforms terrainU, waterU, treeU, lighthouseU, beamU, ringU, hudU, treeCullU, impostorU;
+
+    // Shared uniform blocks, filled and uploaded once at the top of Render. The lantern list
+    // holds the kMaxLanterns lanterns nearest the camera; lanternSlot[i] is the slot of
+    // islands[i]'s lantern, or -1.
+    UniformBuffer<FrameData> frameUbo;
+    UniformBuffer<SceneData> sceneUbo;
+    FrameData frameData;
+    SceneData sceneData;
+    std::vector<int> lanternSlot;
+    std::vector<int> nearestLanterns;
 
 
 
     GLModel treeModel;
+    GLModel treeLodModel;          // clustered from treeModel; empty if that left nothing
+    TreeImpostor treeImpostor;     // not Ready() if disabled or the bake failed
+    static constexpr float kTreeTrunkFrac = 0.35f;
     bool treeModelLoaded = false;
 
     GLModel lighthouseModel;
@@ -1956,7 +1533,7 @@ private:
 
     bool wireframe = false;
 
-    KeyLatch kRegen, kFog, kWire, kStorm, kBeamDbg;
+    KeyLatch kRegen, kFog, kWire, kStorm, kBeamDbg, kGenScaling;
     bool forceBeamDebug = true; 
 
     KeyLatch kBeamWire;
@@ -1969,282 +1546,422 @@ private:
 private:
     Island* NearestIsland(float x, float z)
     {
-        if (islands.empty()) return nullptr;
-
-        glm::vec2 p(x, z);
-        Island* best = &islands[0];
-        float bestD2 = glm::dot(p - islands[0].centerXZ, p - islands[0].centerXZ);
-
-        for (auto& isl : islands)
-        {
-            float d2 = glm::dot(p - isl.centerXZ, p - isl.centerXZ);
-            if (d2 < bestD2)
-            {
-                bestD2 = d2;
-                best = &isl;
-            }
-        }
-        return best;
+        int i = islandIndex.Nearest(glm::vec2(x, z));
+        return i < 0 ? nullptr : &islands[i];
     }
 
-    static IslandBiome PickIslandBiome(std::mt19937& rng)
+    glm::vec3 LanternPosWS(const Island& isl) const
     {
-        std::uniform_real_distribution<float> u(0.0f, 1.0f);
-        float r = u(rng);
-
-        if (r < 0.30f) return IslandBiome::Forest;
-        if (r < 0.55f) return IslandBiome::Grassland;
-        if (r < 0.70f) return IslandBiome::Snow;
-        if (r < 0.85f) return IslandBiome::Desert;
-        return IslandBiome::Village;
+        return isl.lighthousePosWS + glm::vec3(0.0f, cfg.lighthouseLanternHeight * cfg.lighthouseScale, 0.0f);
     }
 
-    // Pick a coastline-ish position: near edge, not too steep, just above sea level.
-    bool FindLighthouseSpot(const Terrain& t, glm::vec3& outLocalPos) const
+    void BuildIslandIndex()
     {
-        const auto& v = t.Verts();
-        if (v.empty()) return false;
-
-        float half = t.HalfSize();
-        float sea = t.seaLevel;
+        std::vector<glm::vec2> centres, lanterns;
+        std::vector<int> lanternIds;
+        centres.reserve(islands.size());
 
-        glm::vec3 best(0.0f);
-        float bestScore = -1e9f;
-        int bestIdx = -1;
-
-        for (int i = 0; i < (int)v.size(); i++)
+        for (int i = 0; i < (int)islands.size(); i++)
         {
-            const glm::vec3 p = v[i].pos;
-            const glm::vec3 n = v[i].normal;
+            centres.push_back(islands[i].centerXZ);
+            if (!islands[i].hasLighthouse) continue;
 
-          
-            if (p.y < sea + 0.10f) continue;
-            if (p.y > sea + 2.20f) continue;
+            glm::vec3 lh = LanternPosWS(islands[i]);
+            lanterns.push_back(glm::vec2(lh.x, lh.z));
+            lanternIds.push_back(i);
+        }
 
-            float r = glm::length(glm::vec2(p.x, p.z));
-            float edge01 = glm::clamp((r - half * 0.70f) / (half * 0.28f), 0.0f, 1.0f);
+        islandIndex.Build(centres);
+        lighthouseIndex.Build(lanterns, lanternIds);
 
-            float flat01 = glm::clamp((n.y - 0.75f) / (1.0f - 0.75f), 0.0f, 1.0f);
+        islandBoxes.Clear();
+        for (const auto& isl : islands)
+            islandBoxes.Push(isl.bounds);
+    }
 
-            float score = edge01 * 2.0f + flat01 * 1.5f;
+    bool IslandVisible(int i) const
+    {
+        return !cfg.frustumCulling || i >= (int)islandVisible.size() || islandVisible[i];
+    }
 
-            if (score > bestScore)
-            {
-                bestScore = score;
-                best = p;
-                bestIdx = i;
-            }
-        }
+    // Synchronous rebuild (startup): same staged path, waited on and uploaded in one go
+    void RebuildWorld(int seed)
+    {
+        BeginRebuild(seed);
+        stagedJob.wait();
+        PumpRebuild(1e30);
+    }
 
-        if (bestIdx < 0) return false;
+    // Starts generating a new world in the background; the current one keeps rendering until
+    // PumpRebuild has uploaded the new one and swaps it in.
+    void BeginRebuild(int seed)
+    {
+        cfg.seed = seed;
 
-        outLocalPos = best;
-        outLocalPos.y = t.SampleHeightAtWorldXZ(outLocalPos.x, outLocalPos.z);
-        return true;
+        staged = std::make_unique<StagedWorld>();
+        staged->seed = seed;
+        staged->started = std::chrono::steady_clock::now();
 
+        StagedWorld* st = staged.get();
+        WorldGenerator gen(cfg, GenAssets());
+        stagedJob = std::async(std::launch::async, [this, st, gen]() { BuildStagedWorldCPU(gen, *st); });
     }
 
+    // Simplified tree mesh, or the full one if simplifying left nothing
+    const GLMesh& TreeLodMesh() const
+    {
+        return treeLodModel.mesh.vao ? treeLodModel.mesh : treeModel.mesh;
+    }
 
-    void RebuildWorld(int seed)
+    void UploadTrees(Island& isl)
     {
-        cfg.seed = seed;
+        isl.trees.InitForMesh(treeModel.mesh);
+        isl.trees.InitLods(treeModel.mesh, TreeLodMesh());
+        isl.trees.UploadInstances();
+    }
 
-        water.y = cfg.seaLevel + cfg.waveStrength * 0.6f + 0.10f;
-        water.BuildFromWorldSize(cfg.oceanHalfSize, cfg.waterSpacing);
-        rings.Reset();
-        islands.clear();
-        islands.resize(cfg.islandCount);
+    // LOD bands of the tree cull pass: x = end of LOD 0, y / z = crossfade from LOD 1 to the
+    // impostor, w = draw distance. Without impostors the crossfade sits at the draw distance.
+    glm::vec4 TreeLodDistances(float drawDist) const
+    {
+        float lod0 = std::min(cfg.treeLodDistance, drawDist);
+        if (!treeImpostor.Ready() || !impostorShader || !impostorShader->linkedOk)
+            return glm::vec4(lod0, drawDist, drawDist, drawDist);
 
-        std::mt19937 rng(cfg.seed);
-        std::uniform_real_distribution<float> ang(0.0f, glm::two_pi<float>());
-        std::uniform_real_distribution<float> rad(0.0f, cfg.islandSpawnRadius);
-        std::uniform_real_distribution<float> chance01(0.0f, 1.0f);
+        float fadeEnd = glm::clamp(cfg.treeImpostorDistance, lod0, drawDist);
+        float fadeStart = glm::clamp(fadeEnd - cfg.treeImpostorFade, lod0, fadeEnd);
+        return glm::vec4(lod0, fadeStart, fadeEnd, drawDist);
+    }
 
-        auto farEnough = [&](const glm::vec2& p, const std::vector<glm::vec2>& placed)
-            {
-                for (const auto& q : placed)
-                {
-                    glm::vec2 d = p - q;
-                    if (glm::dot(d, d) < cfg.islandMinSpacing * cfg.islandMinSpacing)
-                        return false;
-                }
-                return true;
-            };
+    // What the loaded models contribute to generation
+    WorldGenAssets GenAssets() const
+    {
+        WorldGenAssets a;
+        a.treesLoaded = treeModelLoaded;
+        a.treePivotMS = treePivotMS;
+        a.lighthouseLoaded = lighthouseLoaded;
+        a.houseVariants = housesLoaded ? (int)houseModels.size() : 0;
+        if (treeModelLoaded) a.treeBoundsMS = treeModel.bounds;
+        if (lighthouseLoaded) a.lighthouseBoundsMS = lighthouseModel.bounds;
+        if (housesLoaded)
+            for (const auto& m : houseModels) a.houseBoundsMS.push_back(m.bounds);
+        return a;
+    }
+
+    // Background thread: islands (on the generation pool) and their rings. No GL.
+    void BuildStagedWorldCPU(const WorldGenerator& gen, StagedWorld& st) const
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        gen.GenerateIslands(st.seed, genPool.get(), &terrainCache, st.islands);
+        gen.SpawnRings(st.islands, st.seed, st.rings);
+        st.cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
 
-        std::vector<glm::vec2> placed;
-        placed.reserve(cfg.islandCount);
+    // Called once per frame. Once the CPU half is done, uploads staged islands until budgetMs is
+    // used up (at least one per call), then swaps the finished world in. Returns true on swap.
+    bool PumpRebuild(double budgetMs)
+    {
+        if (!staged) return false;
 
-        for (int i = 0; i < cfg.islandCount; i++)
+        if (stagedJob.valid())
         {
-            glm::vec2 pos(0.0f);
-            bool ok = false;
+            if (stagedJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+            stagedJob.get();
+        }
 
-            for (int tries = 0; tries < 300; tries++)
-            {
-                float a = ang(rng);
-                float r = rad(rng);
-                pos = glm::vec2(cos(a), sin(a)) * r;
+        StagedWorld& st = *staged;
+        auto t0 = std::chrono::steady_clock::now();
+        double spent = 0.0;
 
-                if (farEnough(pos, placed))
-                {
-                    ok = true;
-                    break;
-                }
-            }
+        while (st.uploaded < (int)st.islands.size())
+        {
+            Island& isl = st.islands[st.uploaded++];
+            isl.terrain.Upload(&terrainTextures);
 
-            if (!ok)
-            {
-                float a = ang(rng);
-                float r = rad(rng);
-                pos = glm::vec2(cos(a), sin(a)) * r;
-            }
+            if (isl.spawnTrees) UploadTrees(isl);
 
-            placed.push_back(pos);
+            spent = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            if (spent >= budgetMs) break;
+        }
 
-            Island& isl = islands[i];
-            isl.centerXZ = pos;
-            isl.seed = cfg.seed + i * 9991;
+        st.uploadMs += spent;
+        st.uploadFrames++;
 
-            isl.biome = PickIslandBiome(rng);
+        if (st.uploaded < (int)st.islands.size()) return false;
 
-            isl.terrain.seaLevel = cfg.seaLevel;
-            isl.terrain.Build(cfg.terrainGrid, cfg.terrainSpacing, isl.seed, isl.biome);
+        SwapInStagedWorld();
+        return true;
+    }
 
-            isl.model = glm::translate(glm::mat4(1.0f), glm::vec3(pos.x, 0.0f, pos.y));
+    void SwapInStagedWorld()
+    {
+        StagedWorld& st = *staged;
 
-            // Spawn rings for this island
-            int ringCount = 6;
-            if (isl.biome == IslandBiome::Village) ringCount = 10;
-            if (isl.biome == IslandBiome::Snow)    ringCount = 7;
+        BuildWaterIfChanged();
 
-            rings.SpawnForIsland(
-                i,
-                isl.centerXZ,
-                isl.terrain.HalfSize(),
-                ringCount,
-                cfg.seed,
-                // height sampler (local xz)
-                [&](float lx, float lz) { return isl.terrain.SampleHeightAtWorldXZ(lx, lz); },
-                // normal sampler (local xz)
-                [&](float lx, float lz) { return isl.terrain.SampleNormalAtWorldXZ(lx, lz); }
-            );
+        for (auto& isl : islands)
+        {
+            isl.trees.Destroy();
+            isl.terrain.Destroy(&terrainTextures);
+        }
+        islands = std::move(st.islands);
+        rings.TakeRings(st.rings);
+        BuildIslandIndex();
 
+        lastDisplayedScore = -1;
 
-            // Trees
-            bool spawnTrees = (isl.biome == IslandBiome::Forest) || (isl.biome == IslandBiome::Grassland);
-            if (spawnTrees && treeModelLoaded)
-            {
-                isl.trees.InitForMesh(treeModel.mesh);
-                glm::vec3 islandOffset(isl.centerXZ.x, 0.0f, isl.centerXZ.y);
-                isl.trees.PlaceOnTerrain(isl.terrain, isl.seed + 555, islandOffset, treePivotMS);
-                isl.trees.UploadInstances();
-            }
-            else
-            {
-                isl.trees.ClearInstances();
-            }
+        int cacheHits = 0;
+        size_t terrainGpuBytes = 0;
+        for (int i = 0; i < (int)islands.size(); i++)
+        {
+            const Island& isl = islands[i];
+            if (isl.terrain.FromCache()) cacheHits++;
+            terrainGpuBytes += isl.terrain.GpuBytes();
+
+            if (isl.spawnTrees)
+                std::cout << "Trees placed: " << isl.trees.Instances().size() << "\n";
 
-            
-            // -------------------- Village Houses --------------------
-            isl.houses.clear();
             if (isl.biome == IslandBiome::Village && housesLoaded)
-            {
-                // Place a small village on the flatter mid-band area.
-                std::uniform_real_distribution<float> chance01(0.0f, 1.0f);
-                std::uniform_real_distribution<float> yawR(0.0f, glm::two_pi<float>());
-                std::uniform_real_distribution<float> scaleR(2.0f, 3.0f);
+                std::cout << "Village houses placed: " << isl.houses.size() << "\n";
 
-                const int desiredHouses = 8;
-                const int maxTries = desiredHouses * 30;
-                const float minSpacing = 10.0f; // house-to-house spacing in world units
+            std::cout << "Island " << i << " biome: " << IslandBiomeName(isl.biome)
+                << (isl.hasLighthouse ? " + Lighthouse" : "") << "\n";
+        }
 
-                auto tooClose = [&](const glm::vec3& wpos) -> bool
-                {
-                    for (const auto& h : isl.houses)
-                    {
-                        glm::vec3 p = glm::vec3(h.model[3]);
-                        glm::vec2 d = glm::vec2(wpos.x - p.x, wpos.z - p.z);
-                        if (glm::dot(d, d) < minSpacing * minSpacing) return true;
-                    }
-                    return false;
-                };
+        std::cout << "World rebuilt. Seed=" << st.seed
+            << " Islands=" << cfg.islandCount
+            << " Rings=" << rings.GetTotal() << " (short " << rings.GetSpawnShortfall() << ")"
+            << " OceanHalfSize=" << cfg.oceanHalfSize << "\n";
 
-                float half = isl.terrain.HalfSize();
-                glm::vec3 worldOffset(isl.centerXZ.x, 0.0f, isl.centerXZ.y);
+        std::cout << "[Gen] threads=" << (genPool ? genPool->ThreadCount() : 1)
+            << " cpu=" << st.cpuMs << "ms"
+            << " upload=" << st.uploadMs << "ms over " << st.uploadFrames << " frames"
+            << " total=" << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - st.started).count() << "ms"
+            << " worstFrame=" << st.worstFrameMs << "ms"
+            << " terrainCacheHits=" << cacheHits << "/" << islands.size()
+            << " terrainGPU=" << terrainGpuBytes / 1024 << "KB"
+            << " terrainMaps new/reused=" << terrainTextures.Created() << "/" << terrainTextures.Reused() << "\n";
 
-                std::uniform_real_distribution<float> pickXZ(-half * 0.55f, half * 0.55f);
+        staged.reset();
+    }
 
-                for (int tries = 0; tries < maxTries && (int)isl.houses.size() < desiredHouses; tries++)
-                {
-                    float lx = pickXZ(rng);
-                    float lz = pickXZ(rng);
+    // The ocean clipmap only depends on config, so regenerating islands normally leaves it alone
+    void BuildWaterIfChanged()
+    {
+        water.y = cfg.seaLevel + cfg.waveStrength * 0.6f + 0.10f;
+        if (waterBuilt && waterBuiltHalfSize == cfg.oceanHalfSize && waterBuiltSpacing == cfg.waterSpacing
+            && waterBuiltCells == cfg.waterClipmapCells)
+            return;
+
+        water.Build(cfg.oceanHalfSize, cfg.waterSpacing, cfg.waterClipmapCells);
+        waterBuilt = true;
+        waterBuiltHalfSize = cfg.oceanHalfSize;
+        waterBuiltSpacing = cfg.waterSpacing;
+        waterBuiltCells = cfg.waterClipmapCells;
+
+        long long fullGrid = (long long)std::ceil(2.0f * cfg.oceanHalfSize / cfg.waterSpacing) + 1;
+        std::cout << "[Water] clipmap levels=" << water.Levels()
+            << " verts/pass=" << water.VerticesPerPass()
+            << " tris/pass=" << water.TrianglesPerPass()
+            << " (uniform grid " << fullGrid * fullGrid << " verts)\n";
+    }
 
-                    // Prefer mid-band plateau (same idea as Terrain flatten mask)
-                    float r01 = glm::clamp(glm::length(glm::vec2(lx, lz)) / half, 0.0f, 1.0f);
-                    if (r01 < 0.20f || r01 > 0.70f) continue;
+    // Waits for an in-flight rebuild and releases whatever it already uploaded
+    void CancelRebuild()
+    {
+        if (stagedJob.valid()) stagedJob.wait();
+        if (staged)
+        {
+            for (auto& isl : staged->islands)
+            {
+                isl.trees.Destroy();
+                isl.terrain.Destroy(&terrainTextures);
+            }
+            staged.reset();
+        }
+    }
 
-                    float y = isl.terrain.SampleHeightAtWorldXZ(lx, lz);
-                    glm::vec3 n = isl.terrain.SampleNormalAtWorldXZ(lx, lz);
+    // Starts a streamed world: drops whatever is loaded and lets PumpStreaming fill in the cells
+    // around the camera
+    void StartStreaming(int seed)
+    {
+        cfg.seed = seed;
 
-                    if (n.y < 0.90f) continue; // too steep
-                    if (y < cfg.seaLevel + 1.5f) continue; // avoid coast / low land
+        streamer.Clear();
+        for (auto& isl : islands)
+        {
+            isl.trees.Destroy();
+            isl.terrain.Destroy(&terrainTextures);
+        }
+        islands.clear();
+        islandCells.clear();
+        rings.Reset();
 
-                    glm::vec3 posWS = glm::vec3(lx, y, lz) + worldOffset;
-                    if (tooClose(posWS)) continue;
+        BuildWaterIfChanged();
+        streamer.Reset(WorldGenerator(cfg, GenAssets()), seed);
 
-                    // Small chance to skip so villages vary per seed
-                    if (chance01(rng) > 0.35f) continue;
+        BuildIslandIndex();
+        lastDisplayedScore = -1;
 
-                    float yaw = yawR(rng);
-                    float s = scaleR(rng);
+        std::cout << "Streaming world. Seed=" << seed
+            << " cell=" << cfg.streamCellSize << " load radius=" << cfg.streamLoadRadius
+            << " GPU budget=" << cfg.streamGpuBudgetMB << "MB\n";
+    }
 
-                    glm::mat4 T = glm::translate(glm::mat4(1.0f), posWS);
-                    glm::mat4 R = glm::rotate(glm::mat4(1.0f), yaw, glm::vec3(0, 1, 0));
-                    glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(s));
+    // Called once per frame in a streamed world: queues cells near the camera, frees the islands
+    // the streamer gave up on, then uploads finished ones until budgetMs is used up (at least one)
+    void PumpStreaming(double budgetMs)
+    {
+        glm::vec2 camXZ(camera.pos.x, camera.pos.z);
+        // Streamed cells regenerate deterministically from seed and cell, so they skip the disk cache
+        streamer.Update(camXZ, genPool.get(), nullptr);
 
-                    PlacedHouse ph;
-                    ph.variant = (int)(rng() % (unsigned int)houseModels.size());
+        bool changed = false;
 
-// ph.variant = (int)(rng() % (unsigned int)houseModels.size());
-                    ph.model = T * R * S;
+        // before uploading, so the new islands can reuse the freed terrain maps
+        streamer.Evictions(camXZ, evictedCells);
+        for (int cell : evictedCells)
+        {
+            auto it = std::find(islandCells.begin(), islandCells.end(), cell);
+            if (it == islandCells.end()) continue;
 
-                    isl.houses.push_back(ph);
-                }
+            size_t i = it - islandCells.begin();
+            islands[i].trees.Destroy();
+            islands[i].terrain.Destroy(&terrainTextures);
+            rings.RemoveOwner(cell);
 
-                std::cout << "Village houses placed: " << isl.houses.size() << "\n";
+            if (i + 1 != islands.size())
+            {
+                islands[i] = std::move(islands.back());
+                islandCells[i] = islandCells.back();
             }
+            islands.pop_back();
+            islandCells.pop_back();
+            changed = true;
+        }
 
-// Lighthouse
-            isl.hasLighthouse = false;
-            if (lighthouseLoaded && chance01(rng) < cfg.lighthouseChancePerIsland)
+        auto t0 = std::chrono::steady_clock::now();
+        while (std::unique_ptr<StreamedIsland> s = streamer.PopReady(camXZ))
+        {
+            Island& isl = s->island;
+            isl.terrain.Upload(&terrainTextures);
+
+            size_t gpuBytes = isl.terrain.GpuBytes();
+            if (isl.spawnTrees)
             {
-                glm::vec3 localSpot;
-                if (FindLighthouseSpot(isl.terrain, localSpot))
-                {
-                    glm::vec3 worldOffset(isl.centerXZ.x, 0.0f, isl.centerXZ.y);
-                    glm::vec3 posWS = localSpot + worldOffset;
+                UploadTrees(isl);
+                gpuBytes += isl.trees.GpuBytes();
+            }
+            streamer.MarkResident(s->cellId, gpuBytes);
 
-                   
-                    glm::vec2 d = glm::normalize(glm::vec2(localSpot.x, localSpot.z));
-                    float yaw = atan2(d.y, d.x) + glm::pi<float>(); // face outward
+            rings.AppendRings(s->rings, s->cellId);
+            islands.push_back(std::move(isl));
+            islandCells.push_back(s->cellId);
+            changed = true;
 
-                    glm::mat4 T = glm::translate(glm::mat4(1.0f), posWS);
-                    glm::mat4 R = glm::rotate(glm::mat4(1.0f), yaw, glm::vec3(0, 1, 0));
-                    glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(cfg.lighthouseScale));
+            double spent = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            if (spent >= budgetMs) break;
+        }
 
-                    isl.lighthouseModel = T * R * S;
-                    isl.lighthousePosWS = posWS;
-                    isl.hasLighthouse = true;
-                }
+        if (changed)
+        {
+            BuildIslandIndex();
+            lastDisplayedScore = -1;
+        }
+    }
+
+    // Times GenerateIslands for the current seed at 1, 2, 4 ... N threads and checks every run
+    // against the serial checksum, so both the speedup and determinism can be read off the log.
+    void LogGenerationScaling() const
+    {
+        int hw = JobPool::HardwareThreads();
+
+        std::vector<int> counts;
+        for (int t = 1; t < hw; t *= 2) counts.push_back(t);
+        counts.push_back(hw);
+
+        std::cout << "[GenScaling] seed=" << cfg.seed << " islands=" << cfg.islandCount
+            << " grid=" << cfg.terrainGrid << " hardwareThreads=" << hw << "\n";
+
+        WorldGenerator gen(cfg, GenAssets());
+        uint64_t serialSum = 0;
+        double serialMs = 0.0;
+
+        for (int t : counts)
+        {
+            std::unique_ptr<JobPool> pool;
+            if (t > 1) pool = std::make_unique<JobPool>(t);
+
+            // Bypass the heightfield cache so every run pays for full noise generation
+            std::vector<Island> tmp;
+            auto t0 = std::chrono::steady_clock::now();
+            gen.GenerateIslands(cfg.seed, pool.get(), nullptr, tmp);
+            auto t1 = std::chrono::steady_clock::now();
+
+            double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            uint64_t sum = WorldChecksum(tmp);
+            if (t == 1)
+            {
+                serialSum = sum;
+                serialMs = ms;
             }
 
-            std::cout << "Island " << i << " biome: " << IslandBiomeName(isl.biome)
-                << (isl.hasLighthouse ? " + Lighthouse" : "") << "\n";
+            std::cout << "[GenScaling] threads=" << t
+                << " ms=" << ms
+                << " speedup=" << (ms > 0.0 ? serialMs / ms : 0.0)
+                << " checksum=" << std::hex << sum << std::dec
+                << (sum == serialSum ? " (matches serial)" : " (MISMATCH vs serial)") << "\n";
         }
+    }
 
-        std::cout << "World rebuilt. Seed=" << cfg.seed
-            << " Islands=" << cfg.islandCount
-            << " OceanHalfSize=" << cfg.oceanHalfSize << "\n";
+    // Gather normals against the original scatter path on a large grid: timings and the angular
+    // difference (central differences vs averaged face normals are close but not identical).
+    void LogNormalsReport() const
+    {
+        const int grid = 1000;
+        const float meanTolDeg = 1.0f;
+        const float maxTolDeg = 10.0f;
+
+        int seed = islands.empty() ? cfg.seed : islands[0].seed;
+        IslandBiome biome = islands.empty() ? IslandBiome::Grassland : islands[0].biome;
+
+        Terrain t;
+        t.seaLevel = cfg.seaLevel;
+        t.lodLeafCells = cfg.terrainLodLeafCells;
+        t.Build(grid, cfg.terrainSpacing * cfg.terrainGrid / grid, seed, biome, nullptr, genPool.get());
+
+        auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+
+        std::vector<glm::vec3> reference;
+        auto t0 = std::chrono::steady_clock::now();
+        t.ComputeNormalsScatter(reference);
+        auto t1 = std::chrono::steady_clock::now();
+
+        std::vector<glm::vec3> gathered;
+        auto t2 = std::chrono::steady_clock::now();
+        t.ComputeNormals(nullptr, gathered);
+        auto t3 = std::chrono::steady_clock::now();
+        t.ComputeNormals(genPool.get(), gathered);
+        auto t4 = std::chrono::steady_clock::now();
+
+        double maxDeg = 0.0, sumDeg = 0.0;
+        for (size_t i = 0; i < gathered.size(); i++)
+        {
+            float d = glm::clamp(glm::dot(reference[i], gathered[i]), -1.0f, 1.0f);
+            double deg = glm::degrees(std::acos((double)d));
+            maxDeg = std::max(maxDeg, deg);
+            sumDeg += deg;
+        }
+        double meanDeg = gathered.empty() ? 0.0 : sumDeg / gathered.size();
+
+        double scatterMs = ms(t0, t1), gatherMs = ms(t2, t3), parallelMs = ms(t3, t4);
+        std::cout << "[Normals] grid=" << grid
+            << " scatter=" << scatterMs << "ms"
+            << " gather=" << gatherMs << "ms"
+            << " gather(" << (genPool ? genPool->ThreadCount() : 1) << " threads)=" << parallelMs << "ms"
+            << " speedup=" << (parallelMs > 0.0 ? scatterMs / parallelMs : 0.0) << "x\n";
+        std::cout << "[Normals] angle vs scatter: mean=" << meanDeg << "deg max=" << maxDeg << "deg"
+            << ((meanDeg <= meanTolDeg && maxDeg <= maxTolDeg) ? " (within tolerance)" : " (OUT OF TOLERANCE)") << "\n";
     }
 
     void HandleInteraction()
@@ -2258,11 +1975,48 @@ private:
 
         if (kRegen.JustPressed(glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS))
         {
-            cfg.seed = cfg.seed * 1664525 + 1013904223;
-            RebuildWorld(cfg.seed);
+            if (cfg.streamingWorld)
+            {
+                StartStreaming(cfg.seed * 1664525 + 1013904223);
+            }
+            else if (staged)
+            {
+                // one rebuild at a time; the latest request runs when this one lands
+                regenQueued = true;
+                std::cout << "Regeneration already running, queued another\n";
+            }
+            else
+            {
+                BeginRebuild(cfg.seed * 1664525 + 1013904223);
+            }
             if (audio) audio->play2D("assets/sfx/regen.wav", false);
 
         }
+        if (kGenScaling.JustPressed(glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS))
+        {
+            LogNoiseKernelReport();
+            LogGenerationScaling();
+            LogNormalsReport();
+        }
+
+        if (kStats.JustPressed(glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS))
+        {
+            showStats = !showStats;
+            std::cout << "Render stats: " << (showStats ? "ON" : "OFF") << "\n";
+        }
+
+        if (kCull.JustPressed(glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS))
+        {
+            cfg.frustumCulling = !cfg.frustumCulling;
+            std::cout << "Frustum culling: " << (cfg.frustumCulling ? "ON" : "OFF") << "\n";
+        }
+
+        if (kTreeCull.JustPressed(glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS))
+        {
+            cfg.gpuTreeCulling = !cfg.gpuTreeCulling;
+            std::cout << "GPU tree culling / LOD: " << (cfg.gpuTreeCulling ? "ON" : "OFF") << "\n";
+        }
+
         static KeyLatch kLHDbg;
         if (kLHDbg.JustPressed(glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS))
         {
@@ -2304,6 +2058,8 @@ private:
 
     void Render(float timeSeconds)
     {
+        frameStats = FrameStats();
+
         glm::vec3 sunDir = tod.LightDir();
         glm::vec3 sunCol = tod.LightColor();
 
@@ -2336,6 +2092,7 @@ private:
         prevTime = timeSeconds;
         if (dt < 0.0f) dt = 0.0f;
 
+
         float fogDensity = cfg.fogDensity * (cfg.stormMode ? cfg.stormFogMultiplier : 1.0f);
         float waveStrength = cfg.waveStrength * (cfg.stormMode ? cfg.stormWaveMultiplier : 1.0f);
 
@@ -2366,9 +2123,19 @@ private:
         glm::mat4 view = camera.ViewMatrix();
         glm::mat4 proj = glm::perspective(glm::radians(60.f),
             (float)width / (float)height, 2.0f, 5000.f);
-        glm::mat4 model(1.0f);
 
-        sky.Draw(*skyShader, view, proj, sunDir, tod.t01);
+        // an island's box holds its terrain, trees, houses, lighthouse and beam, so a culled
+        // island skips all of them
+        frustum.Extract(proj * view);
+        if (cfg.frustumCulling)
+        {
+            frameStats.islandsVisible = frustum.Cull(islandBoxes, islandVisible);
+            frameStats.islandsCulled = islandBoxes.Size() - frameStats.islandsVisible;
+        }
+        else
+        {
+            frameStats.islandsVisible = (int)islands.size();
+        }
 
         float night = NightFactor(tod.t01);
 
@@ -2378,47 +2145,49 @@ private:
         // Lighthouse light color
         glm::vec3 lhCol(1.0f, 0.95f, 0.80f);
 
-    
-        glm::vec3 waterLhPosWS(0.0f, -99999.0f, 0.0f);
-        float waterLhIntensity = 0.0f;
-
-        int bestIdx = -1;
-        float bestD = 1e30f;
-
-        for (int i = 0; i < (int)islands.size(); i++)
+        // Lanterns within fadeEnd of the camera light the water, fading out from fadeStart
+        float fadeStart = 250.0f;
+        float fadeEnd = 1500.0f;
+        float globalWaterLhMul = 1.25f;
+
+        // ---- SHARED UNIFORM BLOCKS ----
+        frameData.view = view;
+        frameData.proj = proj;
+        frameData.viewPos = camera.pos;
+        frameData.time = timeSeconds;
+        frameData.lightDir = sunDir;
+        frameData.time01 = tod.t01;
+        frameData.lightColor = sunCol;
+        frameData.fogEnabled = cfg.fogEnabled ? 1.0f : 0.0f;
+        frameData.fogColor = cfg.fogColor;
+        frameData.fogDensity = fogDensity;
+        frameData.waveStrength = waveStrength;
+        frameData.waveSpeed = cfg.waveSpeed;
+        frameUbo.Upload(frameData);
+
+        const float lanternIntensity = lightVis * cfg.lighthouseLightStrength;
+
+        lighthouseIndex.KNearest(glm::vec2(camera.pos.x, camera.pos.z), kMaxLanterns, nearestLanterns);
+        lanternSlot.assign(islands.size(), -1);
+        for (int slot = 0; slot < (int)nearestLanterns.size(); slot++)
         {
-            auto& isl = islands[i];
-            if (!isl.hasLighthouse) continue;
+            int i = nearestLanterns[slot];
+            lanternSlot[i] = slot;
+            sceneData.lanterns[slot] = glm::vec4(LanternPosWS(islands[i]), lanternIntensity);
+        }
 
-            glm::vec3 lhPosWS = isl.lighthousePosWS
-                + glm::vec3(0.0f, cfg.lighthouseLanternHeight * cfg.lighthouseScale, 0.0f);
+        sceneData.lanternColor = lhCol;
+        sceneData.seaLevel = cfg.seaLevel;
+        sceneData.beamDir = beamDir;
+        sceneData.beamInnerCos = innerCos;
+        sceneData.beamOuterCos = outerCos;
+        sceneData.beamRange = beamRange;
+        sceneData.waterLightFade = glm::vec2(fadeStart, fadeEnd);
+        sceneData.waterLightStrength = cfg.lighthouseLightStrength * globalWaterLhMul;
+        sceneUbo.Upload(sceneData);
 
-            float d = glm::length(lhPosWS - camera.pos);
-            if (d < bestD)
-            {
-                bestD = d;
-                bestIdx = i;
-            }
-        }
+        sky.Draw(*skyShader);
 
-        // keep current lighthouse unless the new one is closer
-        if (waterLightIdx == -1)
-        {
-            waterLightIdx = bestIdx;
-            waterLightDist = bestD;
-        }
-        else
-        {
-            // if current became invalid, or new is 15% closer, switch
-            if (waterLightIdx < 0 || waterLightIdx >= (int)islands.size() ||
-                !islands[waterLightIdx].hasLighthouse ||
-                (bestIdx != -1 && bestD < waterLightDist * 0.85f))
-            {
-                waterLightIdx = bestIdx;
-                waterLightDist = bestD;
-            }
-        }
-      
         // -------------------------
         // Aim helper (unchanged)
         // -------------------------
@@ -2438,153 +2207,167 @@ private:
                 return R;
             };
 
-        // ============================================================
-        // 1) OPAQUE WORLD FIRST (terrain / houses / lighthouse)
-        // ============================================================
-        for (auto& isl : islands)
-        {
-            float islandBiomeId = (float)(int)isl.biome;
+        // ---- TREE CULL PASS ----
+        // Sorts the trees of visible islands into LOD buffers on the GPU. The counts are read
+        // back when the trees are drawn, after the opaque world, so the pass has time to finish.
+        const bool gpuTreeCull = treeModelLoaded && cfg.gpuTreeCulling && treeCullShader && treeCullShader->linkedOk;
+
+        // fog leaves less than 1/255 of a tree past sqrt(ln 255) / density
+        float treeDrawDist = cfg.treeDrawDistance;
+        if (cfg.fogEnabled && fogDensity > 0.0f) treeDrawDist = std::min(treeDrawDist, 2.354f / fogDensity);
+        const glm::vec4 treeLods = TreeLodDistances(treeDrawDist);
 
-            glm::vec3 lhPosWS(0.0f, -99999.0f, 0.0f);
-            float lhIntensity = 0.0f;
+        if (gpuTreeCull)
+        {
+            treeCullShader->Use();
+            treeCullShader->Set(treeCullU.frustumPlanes, frustum.Planes(), 6);
+            treeCullShader->Set(treeCullU.treeSphere,
+                glm::vec4(treeModel.bounds.Center(), glm::length(treeModel.bounds.Extent())));
+            treeCullShader->Set(treeCullU.lodDistances, treeLods);
 
-            if (isl.hasLighthouse)
+            glEnable(GL_RASTERIZER_DISCARD);
+            for (int i = 0; i < (int)islands.size(); i++)
             {
-                lhPosWS = isl.lighthousePosWS
-                    + glm::vec3(0.0f, cfg.lighthouseLanternHeight * cfg.lighthouseScale, 0.0f);
+                if (IslandVisible(i)) islands[i].trees.CullInstances();
+            }
+            glDisable(GL_RASTERIZER_DISCARD);
+        }
 
-                lhIntensity = lightVis * cfg.lighthouseLightStrength;
+        // ---- RING CULL PASS ----
+        // Same idea for the rings: the survivors are counted on the GPU and drawn after the world
+        if (cfg.frustumCulling && ringCullShader) rings.CullInstances(*ringCullShader, frustum);
 
-                if (isl.hasLighthouse && debugLH && lhPrint.Tick(dt, 1.0f))
-                {
-                    float distToCam = glm::length(lhPosWS - camera.pos);
-                    std::cout << "[LH] distToCam=" << distToCam
-                        << " lhIntensity=" << lhIntensity
-                        << " night=" << night
-                        << "\n";
-                }
-            }
+        // ============================================================
+        // 1) OPAQUE WORLD FIRST (terrain / houses / lighthouse)
+        // Shared constants are set once per shader; each draw only sets its model or lantern slot
+        // ============================================================
 
-            // ---- TERRAIN ----
-            terrainShader->Use();
+        // ---- TERRAIN ----
+        terrainShader->Use();
 
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, texSand);
-            terrainShader->SetInt("uTexSand", 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texSand);
+        terrainShader->Set(terrainU.texSand, 0);
 
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, texGrass);
-            terrainShader->SetInt("uTexGrass", 1);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texGrass);
+        terrainShader->Set(terrainU.texGrass, 1);
 
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, texRock);
-            terrainShader->SetInt("uTexRock", 2);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, texRock);
+        terrainShader->Set(terrainU.texRock, 2);
 
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, texSnow);
-            terrainShader->SetInt("uTexSnow", 3);
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, texSnow);
+        terrainShader->Set(terrainU.texSnow, 3);
 
-            terrainShader->SetFloat("uTexTiling", texTiling);
-            terrainShader->SetFloat("uUseTextures", useTextures ? 1.0f : 0.0f);
+        terrainShader->Set(terrainU.texTiling, texTiling);
+        terrainShader->Set(terrainU.useTextures, useTextures ? 1.0f : 0.0f);
+        Terrain::SetMaterial(*terrainShader);
 
-            isl.terrain.Draw(*terrainShader, isl.model, view, proj, camera,
-                sunDir, sunCol,
-                cfg.fogEnabled, cfg.fogColor, fogDensity,
-                islandBiomeId,
-                (float)isl.seed,
-                lhPosWS, lhCol, lhIntensity,
-                beamDir, innerCos, outerCos,
-                beamRange);
+        for (int i = 0; i < (int)islands.size(); i++)
+        {
+            if (!IslandVisible(i)) continue;
+            Island& isl = islands[i];
 
-            // ---- LIGHTHOUSE MODEL (OPAQUE) ----
-            if (lighthouseLoaded && isl.hasLighthouse)
+            if (isl.hasLighthouse && debugLH && lhPrint.Tick(dt, 1.0f))
             {
-                lighthouseShader->Use();
-                lighthouseShader->SetMat4("uModel", glm::value_ptr(isl.lighthouseModel));
-                lighthouseShader->SetMat4("uView", glm::value_ptr(view));
-                lighthouseShader->SetMat4("uProj", glm::value_ptr(proj));
-
-                lighthouseShader->SetVec3("uViewPos", camera.pos.x, camera.pos.y, camera.pos.z);
-                lighthouseShader->SetVec3("uLightDir", sunDir.x, sunDir.y, sunDir.z);
-                lighthouseShader->SetVec3("uLightColor", sunCol.x, sunCol.y, sunCol.z);
+                float distToCam = glm::length(LanternPosWS(isl) - camera.pos);
+                std::cout << "[LH] distToCam=" << distToCam
+                    << " lhIntensity=" << lanternIntensity
+                    << " slot=" << lanternSlot[i]
+                    << " night=" << night
+                    << "\n";
+            }
 
-                lighthouseShader->SetFloat("uAmbientStrength", 0.22f);
-                lighthouseShader->SetFloat("uSpecStrength", 0.35f);
-                lighthouseShader->SetFloat("uShininess", 64.0f);
+            frameStats.terrainTriangles += isl.terrain.Draw(*terrainShader, TerrainPatch(), terrainLod,
+                isl.model, camera.pos,
+                (float)(int)isl.biome,
+                (float)isl.seed,
+                lanternSlot[i]);
+            frameStats.terrainNodes += isl.terrain.LodNodesDrawn();
+        }
 
-                lighthouseShader->SetFloat("uFogEnabled", cfg.fogEnabled ? 1.0f : 0.0f);
-                lighthouseShader->SetVec3("uFogColor", cfg.fogColor.x, cfg.fogColor.y, cfg.fogColor.z);
-                lighthouseShader->SetFloat("uFogDensity", fogDensity);
+        // ---- LIGHTHOUSE MODELS (OPAQUE) ----
+        if (lighthouseLoaded)
+        {
+            lighthouseShader->Use();
+            lighthouseShader->Set(lighthouseU.ambientStrength, 0.22f);
+            lighthouseShader->Set(lighthouseU.specStrength, 0.35f);
+            lighthouseShader->Set(lighthouseU.shininess, 64.0f);
 
-                lighthouseShader->SetFloat("uNightFactor", night);
-                lighthouseShader->SetVec3("uLanternPosWS", lhPosWS.x, lhPosWS.y, lhPosWS.z);
-                lighthouseShader->SetVec3("uLanternColor", lhCol.x, lhCol.y, lhCol.z);
-                lighthouseShader->SetFloat("uLanternIntensity", lhIntensity);
+            lighthouseModel.mesh.Bind();
+            for (int i = 0; i < (int)islands.size(); i++)
+            {
+                const Island& isl = islands[i];
+                if (!isl.hasLighthouse) continue;
+                if (!IslandVisible(i) || (cfg.frustumCulling && !frustum.Visible(isl.lighthouseBounds)))
+                {
+                    frameStats.lighthousesCulled++;
+                    continue;
+                }
+                frameStats.lighthousesVisible++;
 
-                lighthouseModel.mesh.Bind();
+                lighthouseShader->Set(lighthouseU.model, isl.lighthouseModel);
                 glDrawElements(GL_TRIANGLES, lighthouseModel.mesh.indexCount, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
             }
+            glBindVertexArray(0);
+        }
 
-            // ---- HOUSES (OPAQUE) ----
-            if (housesLoaded && !isl.houses.empty())
-            {
-                GLboolean wasCull = glIsEnabled(GL_CULL_FACE);
-                glDisable(GL_CULL_FACE);
-
-                Shader& hs = *lighthouseShader;
-                hs.Use();
-                hs.SetMat4("uView", glm::value_ptr(view));
-                hs.SetMat4("uProj", glm::value_ptr(proj));
-                hs.SetVec3("uViewPos", camera.pos.x, camera.pos.y, camera.pos.z);
-
-                hs.SetVec3("uLightDir", sunDir.x, sunDir.y, sunDir.z);
-                hs.SetVec3("uLightColor", sunCol.x, sunCol.y, sunCol.z);
-
-                hs.SetFloat("uAmbientStrength", 0.22f);
-                hs.SetFloat("uSpecStrength", 0.25f);
-                hs.SetFloat("uShininess", 48.0f);
+        // ---- HOUSES (OPAQUE) ----
+        if (housesLoaded)
+        {
+            GLboolean wasCull = glIsEnabled(GL_CULL_FACE);
+            glDisable(GL_CULL_FACE);
 
-                hs.SetFloat("uFogEnabled", cfg.fogEnabled ? 1.0f : 0.0f);
-                hs.SetVec3("uFogColor", cfg.fogColor.x, cfg.fogColor.y, cfg.fogColor.z);
-                hs.SetFloat("uFogDensity", fogDensity);
+            Shader& hs = *lighthouseShader;
+            hs.Use();
+            hs.Set(lighthouseU.ambientStrength, 0.22f);
+            hs.Set(lighthouseU.specStrength, 0.25f);
+            hs.Set(lighthouseU.shininess, 48.0f);
 
-                hs.SetFloat("uNightFactor", night);
-                hs.SetVec3("uLanternPosWS", lhPosWS.x, lhPosWS.y, lhPosWS.z);
-                hs.SetVec3("uLanternColor", lhCol.x, lhCol.y, lhCol.z);
-                hs.SetFloat("uLanternIntensity", lhIntensity);
+            for (int i = 0; i < (int)islands.size(); i++)
+            {
+                if (!IslandVisible(i))
+                {
+                    frameStats.housesCulled += (int)islands[i].houses.size();
+                    continue;
+                }
 
-                for (const auto& h : isl.houses)
+                for (const auto& h : islands[i].houses)
                 {
+                    if (cfg.frustumCulling && !frustum.Visible(h.bounds))
+                    {
+                        frameStats.housesCulled++;
+                        continue;
+                    }
+                    frameStats.housesVisible++;
+
                     int vi = (h.variant >= 0 && h.variant < (int)houseModels.size()) ? h.variant : 0;
-                    hs.SetMat4("uModel", glm::value_ptr(h.model));
+                    hs.Set(lighthouseU.model, h.model);
 
                     houseModels[vi].mesh.Bind();
                     glDrawElements(GL_TRIANGLES, houseModels[vi].mesh.indexCount, GL_UNSIGNED_INT, 0);
                     glBindVertexArray(0);
                 }
-
-                if (wasCull) glEnable(GL_CULL_FACE);
-                else glDisable(GL_CULL_FACE);
             }
-        }
 
-        waterShader->Use();
-        waterShader->SetFloat("uAdditiveOnly", 0.0f);
+            if (wasCull) glEnable(GL_CULL_FACE);
+            else glDisable(GL_CULL_FACE);
+        }
 
 // BASE WATER 
-        water.Draw(*waterShader, model, view, proj, camera, sunDir, sunCol,
-            timeSeconds, waveStrength, cfg.waveSpeed,
-            cfg.fogEnabled, cfg.fogColor, fogDensity,
-            glm::vec3(0.0f, -99999.0f, 0.0f), lhCol, 0.0f,
-            beamDir, innerCos, outerCos,
-            beamRange);
+        water.SetMaterial(*waterShader);
+        waterShader->Set(waterU.additiveOnly, 0.0f);
+        waterShader->Set(waterU.lightIndex, -1);
+        water.Draw(*waterShader, camera.pos);
 
 
 
-        // ADD ALL LIGHTHOUSES CONTRIBUTION (water) - normalized + distance faded
-        int lhCount = 0;
-        for (auto& isl : islands) if (isl.hasLighthouse) lhCount++;
+        // ADD ALL LIGHTHOUSES CONTRIBUTION (water) - normalized + distance faded (in water.frag)
+        // Lanterns past fadeEnd add nothing, so only the ones within it are drawn
+        lighthouseIndex.Radius(glm::vec2(camera.pos.x, camera.pos.z), fadeEnd, nearbyLighthouses);
+        int lhCount = (int)nearbyLighthouses.size();
 
         if (lhCount > 0)
         {
@@ -2604,67 +2387,33 @@ private:
             glDepthFunc(GL_LEQUAL);
 
             waterShader->Use();
-            waterShader->SetFloat("uAdditiveOnly", 1.0f);
-
-            // kill sun lighting during additive passes
-            waterShader->SetFloat("uAmbientStrength", 0.0f);
-            waterShader->SetFloat("uSpecStrength", 0.0f);
-			waterShader->SetVec3("uLightColor", 0.0f, 0.0f, 0.0f);
-
-          
-            float globalWaterLhMul = 1.25f;  
-            float perLightNorm = 1.0f;        
-
-           
-            float fadeStart = 250.0f;
-            float fadeEnd = 1500.0f;
+            waterShader->Set(waterU.additiveOnly, 1.0f);
 
-
-     
             int printed = 0;
 
-            for (int i = 0; i < (int)islands.size(); i++)
+            for (int i : nearbyLighthouses)
             {
-                auto& isl = islands[i];
-                if (!isl.hasLighthouse) continue;
-
-                glm::vec3 lhPosWS = isl.lighthousePosWS
-                    + glm::vec3(0.0f, cfg.lighthouseLanternHeight * cfg.lighthouseScale, 0.0f);
-
-                float d = glm::length(lhPosWS - camera.pos);
-
-                // 1 near, 0 far
-                float fade = 1.0f - glm::smoothstep(fadeStart, fadeEnd, d);
-                fade = glm::clamp(fade, 0.0f, 1.0f);
-               
-                float lhIntensity =
-                    cfg.lighthouseLightStrength *
-                    globalWaterLhMul *
-                    fade;   
-
-
-
+                // past the kMaxLanterns nearest; only happens with more than that within fadeEnd
+                if (lanternSlot[i] < 0) continue;
 
                 if (doDbg && printed == 0)
                 {
+                    float d = glm::length(LanternPosWS(islands[i]) - camera.pos);
+                    float fade = 1.0f - glm::smoothstep(fadeStart, fadeEnd, d);
+
                     std::cout
                         << "[WATER-LH] islandIndex=" << i
                         << " lhCount=" << lhCount
                         << " d=" << d
                         << " fade=" << fade
-                        << " perLightNorm=" << perLightNorm
-                        << " lhIntensity=" << lhIntensity
+                        << " lhIntensity=" << sceneData.waterLightStrength * fade
                         << " beamRange=" << beamRange
                         << "\n";
                     printed++;
                 }
 
-                water.Draw(*waterShader, model, view, proj, camera, sunDir, sunCol,
-                    timeSeconds, waveStrength, cfg.waveSpeed,
-                    cfg.fogEnabled, cfg.fogColor, fogDensity,
-                    lhPosWS, lhCol, lhIntensity,
-                    beamDir, innerCos, outerCos,
-                    beamRange);
+                waterShader->Set(waterU.lightIndex, lanternSlot[i]);
+                water.Draw(*waterShader, camera.pos);
             }
 
             // Optional GL error check (prints only when an error occurs)
@@ -2702,49 +2451,37 @@ private:
             glGetIntegerv(GL_POLYGON_MODE, prevMode);
             glPolygonMode(GL_FRONT_AND_BACK, forceBeamWire ? GL_LINE : GL_FILL);
 
-            for (auto& isl : islands)
-            {
-                if (!isl.hasLighthouse) continue;
-
-                glm::vec3 lhPosWS = isl.lighthousePosWS
-                    + glm::vec3(0.0f, cfg.lighthouseLanternHeight * cfg.lighthouseScale, 0.0f);
-
-      
-                float scaleY = (cfg.lighthouseBeamLength) / 10.0f;   
-                float scaleR = (cfg.lighthouseBeamRadius) / 6.0f;    
-
-                glm::mat4 T = glm::translate(glm::mat4(1.0f), lhPosWS);
-
-            
-                glm::mat4 R = AimMatrixFromDirY(beamDir);
-
-                glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(scaleR, scaleY, scaleR));
-                glm::mat4 beamM = T * R * S;
+            // colour (the lantern's) and fog come from the uniform blocks
+            beamShader->Use();
+            beamShader->Set(beamU.beamStrength, cfg.lighthouseBeamStrength);
 
-                beamShader->Use();
-                beamShader->SetMat4("uModel", glm::value_ptr(beamM));
-                beamShader->SetMat4("uView", glm::value_ptr(view));
-                beamShader->SetMat4("uProj", glm::value_ptr(proj));
+            // THIS is the debug toggle your shader uses
+            beamShader->Set(beamU.debugWire, forceBeamWire ? 1.0f : 0.0f);
 
-                // REQUIRED uniforms (this is what fixes the black box)
-                beamShader->SetVec3("uViewPos", camera.pos.x, camera.pos.y, camera.pos.z);
-                beamShader->SetVec3("uBeamColor", lhCol.x, lhCol.y, lhCol.z);
-                beamShader->SetFloat("uBeamStrength", cfg.lighthouseBeamStrength);
+            float scaleY = (cfg.lighthouseBeamLength) / 10.0f;
+            float scaleR = (cfg.lighthouseBeamRadius) / 6.0f;
 
-                // THIS is the debug toggle your shader uses
-                beamShader->SetFloat("uDebugWire", forceBeamWire ? 1.0f : 0.0f);
+            // every beam points the same way this frame
+            glm::mat4 RS = AimMatrixFromDirY(beamDir) * glm::scale(glm::mat4(1.0f), glm::vec3(scaleR, scaleY, scaleR));
 
+            beamModel.mesh.Bind();
+            for (int i = 0; i < (int)islands.size(); i++)
+            {
+                const Island& isl = islands[i];
+                if (!isl.hasLighthouse) continue;
+                if (!IslandVisible(i) || (cfg.frustumCulling
+                    && !frustum.Visible(glm::vec3(isl.beamSphere), isl.beamSphere.w)))
+                {
+                    frameStats.beamsCulled++;
+                    continue;
+                }
+                frameStats.beamsVisible++;
 
-
-                // Fog uniforms used by beam.frag
-                beamShader->SetFloat("uFogEnabled", cfg.fogEnabled ? 1.0f : 0.0f);
-                beamShader->SetVec3("uFogColor", cfg.fogColor.x, cfg.fogColor.y, cfg.fogColor.z);
-                beamShader->SetFloat("uFogDensity", fogDensity);
-
-                beamModel.mesh.Bind();
+                glm::mat4 beamM = glm::translate(glm::mat4(1.0f), LanternPosWS(isl)) * RS;
+                beamShader->Set(beamU.model, beamM);
                 glDrawElements(GL_TRIANGLES, beamModel.mesh.indexCount, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
             }
+            glBindVertexArray(0);
 
             // Restore state
             glPolygonMode(GL_FRONT_AND_BACK, prevMode[0]);
@@ -2774,18 +2511,10 @@ private:
             glBindTexture(GL_TEXTURE_2D, texRing);
 
             ringShader->Use();
-            ringShader->SetInt("uRingTex", 0);
-
-            rings.Draw(
-                *ringShader,
-                view, proj,
-                camera,
-                sunDir, sunCol,
-                cfg.fogEnabled,
-                cfg.fogColor,
-                fogDensity,
-                night
-            );
+            ringShader->Set(ringU.ringTex, 0);
+
+            frameStats.ringsVisible = rings.Draw(*ringShader);
+            frameStats.ringsCulled = (int)rings.Rings().size() - frameStats.ringsVisible;
 
             glBindTexture(GL_TEXTURE_2D, 0);
             glDepthMask(GL_TRUE);
@@ -2794,64 +2523,92 @@ private:
 
   
   // ---- TREES (instanced) ----
-        for (auto& isl : islands)
+        if (treeModelLoaded)
         {
-            glm::vec3 lhPosWS(0.0f, -99999.0f, 0.0f);
-            float lhIntensity = 0.0f;
-
-            if (isl.hasLighthouse)
-            {
-                lhPosWS = isl.lighthousePosWS
-                    + glm::vec3(0.0f, cfg.lighthouseLanternHeight * cfg.lighthouseScale, 0.0f);
-                lhIntensity = lightVis * cfg.lighthouseLightStrength;
-            }
+            treeShader->Use();
 
-            if (treeModelLoaded)
-            {
-                treeShader->Use();
+            treeShader->Set(treeU.ambientStrength, 0.25f);
+            treeShader->Set(treeU.specStrength, 0.15f);
+            treeShader->Set(treeU.shininess, 16.0f);
 
-                treeShader->SetMat4("uView", glm::value_ptr(view));
-                treeShader->SetMat4("uProj", glm::value_ptr(proj));
-                treeShader->SetVec3("uViewPos", camera.pos.x, camera.pos.y, camera.pos.z);
-                treeShader->SetVec3("uLightDir", sunDir.x, sunDir.y, sunDir.z);
-                treeShader->SetVec3("uLightColor", sunCol.x, sunCol.y, sunCol.z);
+            treeShader->Set(treeU.treeMinY, treeTrunkMinY);
+            treeShader->Set(treeU.treeMaxY, treeModelMaxY);
+            treeShader->Set(treeU.trunkFrac, kTreeTrunkFrac);
 
-                treeShader->SetFloat("uAmbientStrength", 0.25f);
-                treeShader->SetFloat("uSpecStrength", 0.15f);
-                treeShader->SetFloat("uShininess", 16.0f);
+            // the impostor crossfade only happens with the GPU LOD pass
+            treeShader->Set(treeU.impostorFade, gpuTreeCull ? glm::vec2(treeLods.y, treeLods.z) : glm::vec2(1e9f));
 
-                treeShader->SetFloat("uFogEnabled", cfg.fogEnabled ? 1.0f : 0.0f);
-                treeShader->SetVec3("uFogColor", cfg.fogColor.x, cfg.fogColor.y, cfg.fogColor.z);
-                treeShader->SetFloat("uFogDensity", fogDensity);
+            glEnable(GL_DEPTH_TEST);
+            glDepthMask(GL_TRUE);
 
-                treeShader->SetFloat("uTime", timeSeconds);
+            glDisable(GL_BLEND);
 
-                treeShader->SetFloat("uTreeMinY", treeTrunkMinY);
-                treeShader->SetFloat("uTreeMaxY", treeModelMaxY);
-                treeShader->SetFloat("uTrunkFrac", 0.35f);
+            glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE);
 
-                treeShader->SetVec3("uPointLightPos", lhPosWS.x, lhPosWS.y, lhPosWS.z);
-                treeShader->SetVec3("uPointLightColor", lhCol.x, lhCol.y, lhCol.z);
-                treeShader->SetFloat("uPointLightIntensity", lhIntensity);
-                treeShader->SetVec3("uBeamDir", beamDir.x, beamDir.y, beamDir.z);
-                treeShader->SetFloat("uBeamInnerCos", innerCos);
-                treeShader->SetFloat("uBeamOuterCos", outerCos);
+            const GLsizei lodIndexCounts[2] = { treeModel.mesh.indexCount, TreeLodMesh().indexCount };
 
+            for (int i = 0; i < (int)islands.size(); i++)
+            {
+                const TreeSystem& trees = islands[i].trees;
+                frameStats.treesTotal += (int)trees.Instances().size();
+                if (!IslandVisible(i)) continue;
 
-                glEnable(GL_DEPTH_TEST);
-                glDepthMask(GL_TRUE);
+                treeShader->Set(treeU.lightIndex, lanternSlot[i]);
+                if (gpuTreeCull)
+                {
+                    for (int k = 0; k < 2; k++)
+                    {
+                        int n = trees.DrawLod(k, lodIndexCounts[k]);
+                        frameStats.treesLod[k] += n;
+                        frameStats.treeTriangles += (long long)n * (lodIndexCounts[k] / 3);
+                    }
+                }
+                else
+                {
+                    trees.DrawInstanced(treeModel.mesh.indexCount);
+                    frameStats.treesLod[0] += (int)trees.Instances().size();
+                    frameStats.treeTriangles += (long long)trees.Instances().size() * (lodIndexCounts[0] / 3);
+                }
+            }
 
-               
-                glDisable(GL_BLEND);
+            // ---- TREE IMPOSTORS ----
+            if (gpuTreeCull && treeLods.z < treeLods.w)
+            {
+                impostorShader->Use();
+                impostorShader->Set(impostorU.ambientStrength, 0.25f);
+                impostorShader->Set(impostorU.specStrength, 0.15f);
+                impostorShader->Set(impostorU.shininess, 16.0f);
+                impostorShader->Set(impostorU.treeSphere, treeImpostor.Sphere());
+                impostorShader->Set(impostorU.frames, treeImpostor.Frames());
+                impostorShader->Set(impostorU.impostorFade, glm::vec2(treeLods.y, treeLods.z));
+
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, treeImpostor.AlbedoTexture());
+                impostorShader->Set(impostorU.albedoAtlas, 0);
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D, treeImpostor.NormalTexture());
+                impostorShader->Set(impostorU.normalAtlas, 1);
 
-             
-                glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+                GLboolean wasCull = glIsEnabled(GL_CULL_FACE);
+                glDisable(GL_CULL_FACE);
 
-                isl.trees.DrawInstanced(treeModel.mesh.indexCount);
+                for (int i = 0; i < (int)islands.size(); i++)
+                {
+                    if (!IslandVisible(i)) continue;
 
-                glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+                    impostorShader->Set(impostorU.lightIndex, lanternSlot[i]);
+                    int n = islands[i].trees.DrawLod(TreeSystem::kImpostorLod, 0);
+                    frameStats.treesLod[TreeSystem::kImpostorLod] += n;
+                    frameStats.treeTriangles += 2LL * n;
+                }
 
+                if (wasCull) glEnable(GL_CULL_FACE);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, 0);
             }
+
+            glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
         }
 
         // ---- HELP OVERLAY ----
@@ -2864,8 +2621,8 @@ private:
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
             hudShader->Use();
-            hudShader->SetInt("uTex", 0);
-            hudShader->SetFloat("uAlpha", 0.92f);
+            hudShader->Set(hudU.tex, 0);
+            hudShader->Set(hudU.alpha, 0.92f);
 
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_2D, texHelp);
@@ -2880,6 +2637,41 @@ private:
             glDepthMask(GL_TRUE);
             glEnable(GL_DEPTH_TEST);
         }
+
+        if (showStats && statsPrint.Tick(dt, 1.0f))
+        {
+            // what the same islands cost as full-resolution grids
+            long long fullGridTris = 2LL * cfg.terrainGrid * cfg.terrainGrid * (long long)islands.size();
+
+            std::cout << "[Stats] terrain tris/frame=" << frameStats.terrainTriangles
+                << " (full grid " << fullGridTris << ")"
+                << " nodes=" << frameStats.terrainNodes << "\n";
+
+            const FrameStats& f = frameStats;
+            std::cout << "[Cull] " << (cfg.frustumCulling ? "on" : "off")
+                << " visible/culled islands=" << f.islandsVisible << "/" << f.islandsCulled
+                << " houses=" << f.housesVisible << "/" << f.housesCulled
+                << " lighthouses=" << f.lighthousesVisible << "/" << f.lighthousesCulled
+                << " beams=" << f.beamsVisible << "/" << f.beamsCulled
+                << " rings=" << f.ringsVisible << "/" << f.ringsCulled << "\n";
+
+            std::cout << "[Trees] " << (cfg.gpuTreeCulling ? "gpu cull" : "all drawn")
+                << " total=" << f.treesTotal
+                << " mesh=" << f.treesLod[0]
+                << " simplified=" << f.treesLod[1]
+                << " impostor=" << f.treesLod[TreeSystem::kImpostorLod]
+                << " tris=" << f.treeTriangles << "\n";
+
+            if (cfg.streamingWorld)
+            {
+                const StreamCounters& sc = streamer.Counters();
+                std::cout << "[Stream] resident=" << sc.residentIslands
+                    << " queue=" << sc.queueDepth
+                    << " gpu=" << sc.gpuBytes / 1024 << "KB (budget " << cfg.streamGpuBudgetMB << "MB)"
+                    << " generated=" << sc.generated
+                    << " evicted=" << sc.evicted << " (over budget " << sc.evictedForBudget << ")\n";
+            }
+        }
     }
 
 };
@@ -10,29 +10,34 @@ in VS_OUT {
 
 out vec4 FragColor;
 
-uniform vec3  uViewPos;
-uniform vec3  uLightDir;
-uniform vec3  uLightColor;
-
-uniform vec3  uPointLightPos;
-uniform vec3  uPointLightColor;
-uniform float uPointLightIntensity;
-
-uniform vec3  uBeamDir;
-uniform float uBeamInnerCos;
-uniform float uBeamOuterCos;
-uniform float uBeamRange;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
+
+// Lanterns, beam and sea level; written once per frame (SceneData in FrameUniforms.h)
+layout(std140) uniform SceneData
+{
+    vec4  uLanterns[256];    // xyz = position, w = intensity
+    vec3  uLanternColor;     float uSeaLevel;
+    vec3  uBeamDir;          float uBeamInnerCos;
+    float uBeamOuterCos;     float uBeamRange;     vec2 uWaterLightFade;   // x = start, y = end
+    float uWaterLightStrength;
+};
+
+uniform int   uLightIndex;      // this island's lantern in uLanterns, -1 = none
+
 uniform float uAmbientStrength;
 uniform float uSpecStrength;
 uniform float uShininess;
 
-uniform float uSeaLevel;
-
-// Fog controls
-uniform float uFogEnabled;
-uniform vec3  uFogColor;
-uniform float uFogDensity;
-
 // Island biome + seed
 uniform float uIslandBiome;
 uniform float uIslandSeed;
@@ -253,9 +258,9 @@ vec3 biomeColor(float h, float m, float slope)
     return land;
 }
 
-vec3 ApplyPointAndBeam(vec3 baseCol, vec3 N, vec3 V)
+vec3 ApplyPointAndBeam(vec3 baseCol, vec3 N, vec3 V, vec4 lantern)
 {
-    vec3 toLight = uPointLightPos - fs_in.worldPos;
+    vec3 toLight = lantern.xyz - fs_in.worldPos;
     float dist = length(toLight);
     if (dist < 0.0001) return vec3(0.0);
 
@@ -267,10 +272,10 @@ vec3 ApplyPointAndBeam(vec3 baseCol, vec3 N, vec3 V)
     vec3 Hp = normalize(Lp + V);
     float specP = pow(max(dot(N, Hp), 0.0), uShininess);
 
-    vec3 point = (diffP * baseCol + (uSpecStrength * specP) * vec3(1.0)) * uPointLightColor;
-    point *= atten * uPointLightIntensity;
+    vec3 point = (diffP * baseCol + (uSpecStrength * specP) * vec3(1.0)) * uLanternColor;
+    point *= atten * lantern.w;
 
-    vec3 lightToFrag = normalize(fs_in.worldPos - uPointLightPos);
+    vec3 lightToFrag = normalize(fs_in.worldPos - lantern.xyz);
     float cosAng = dot(lightToFrag, normalize(uBeamDir));
     float spot = smoothstep(uBeamOuterCos, uBeamInnerCos, cosAng);
 
@@ -328,8 +333,8 @@ void main()
 
     vec3 color = ambient + diffuse + specular;
 
-    if (uPointLightIntensity > 0.001)
-        color += ApplyPointAndBeam(baseCol, N, V);
+    if (uLightIndex >= 0 && uLanterns[uLightIndex].w > 0.001)
+        color += ApplyPointAndBeam(baseCol, N, V, uLanterns[uLightIndex]);
 
     if (uFogEnabled > 0.5)
     {
@@ -1,37 +1,96 @@
 #version 410 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in float aMoisture;
-layout (location = 3) in vec2 aUV;       
+// CDLOD terrain: one shared grid patch, placed per quadtree node and displaced from the heightmap.
+// No vertex attributes; the patch grid position comes from gl_VertexID.
+
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
+
+uniform sampler2D uTerrainMap;  // r = height (quantized over uHeightRange), gb = octahedral normal, a = moisture
+uniform vec3 uHeightmapInfo;    // x = half size, y = 1 / spacing, z = 1 / texels per side
+uniform vec2 uHeightRange;      // x = min height, y = max - min
+
+uniform float uPatchQuads;
+uniform vec2 uNodeOrigin;       // island-local xz of the node corner
+uniform float uNodeSize;
+uniform vec2 uMorphRange;       // x = morph start distance, y = 1 / (end - start)
 
 out VS_OUT {
     vec3 worldPos;
     vec3 normal;
     float moisture;
     float height;
-    vec2 uv;                               
+    vec2 uv;
 } vs_out;
 
+vec2 HeightmapUV(vec2 local)
+{
+    vec2 grid = (local + uHeightmapInfo.x) * uHeightmapInfo.y;
+    return (grid + 0.5) * uHeightmapInfo.z;
+}
+
+float SampleHeight(vec2 tuv)
+{
+    return uHeightRange.x + textureLod(uTerrainMap, tuv, 0.0).r * uHeightRange.y;
+}
+
+vec3 OctDecode(vec2 e)
+{
+    e = e * 2.0 - 1.0;
+    vec3 n = vec3(e.x, 1.0 - abs(e.x) - abs(e.y), e.y);
+    if (n.y < 0.0)
+    {
+        vec2 s = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.z >= 0.0 ? 1.0 : -1.0);
+        n.xz = (1.0 - abs(n.zx)) * s;
+    }
+    return normalize(n);
+}
+
 void main()
 {
-    vec4 wp = uModel * vec4(aPos, 1.0);
+    int side = int(uPatchQuads) + 1;
+    vec2 aGridPos = vec2(gl_VertexID % side, gl_VertexID / side);
+
+    float cellSize = uNodeSize / uPatchQuads;
+    vec2 local = uNodeOrigin + aGridPos * cellSize;
+
+    // geomorph: odd vertices slide onto their even neighbours as the node nears its band edge,
+    // so the switch to the parent level is seamless
+    float h0 = SampleHeight(HeightmapUV(local));
+    vec3 approxWS = (uModel * vec4(local.x, h0, local.y, 1.0)).xyz;
+    float morphK = clamp((distance(approxWS, uViewPos) - uMorphRange.x) * uMorphRange.y, 0.0, 1.0);
+
+    local -= mod(aGridPos, 2.0) * cellSize * morphK;
+    local = clamp(local, vec2(-uHeightmapInfo.x), vec2(uHeightmapInfo.x));
+
+    vec2 tuv = HeightmapUV(local);
+    vec4 texel = textureLod(uTerrainMap, tuv, 0.0);
+    float h = uHeightRange.x + texel.r * uHeightRange.y;
+
+    vec4 wp = uModel * vec4(local.x, h, local.y, 1.0);
     vs_out.worldPos = wp.xyz;
 
     mat3 normalMat = transpose(inverse(mat3(uModel)));
-    vs_out.normal = normalize(normalMat * aNormal);
+    vs_out.normal = normalize(normalMat * OctDecode(texel.gb));
 
-    vs_out.moisture = aMoisture;
+    vs_out.moisture = texel.a;
 
     // Height already baked in C++
-    vs_out.height = aPos.y;
+    vs_out.height = h;
 
-    // Pass UV through
-    vs_out.uv = aUV;                      
+    // Same world-xz tiling the CPU grid used
+    vs_out.uv = local * 0.05;
 
     gl_Position = uProj * uView * wp;
 }
@@ -4,15 +4,31 @@ in vec3 vLocalPos;
 
 out vec4 FragColor;
 
-uniform vec3  uViewPos;
-uniform vec3  uBeamColor;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
+
+// Lanterns, beam and sea level; written once per frame (SceneData in FrameUniforms.h)
+layout(std140) uniform SceneData
+{
+    vec4  uLanterns[256];    // xyz = position, w = intensity
+    vec3  uLanternColor;     float uSeaLevel;
+    vec3  uBeamDir;          float uBeamInnerCos;
+    float uBeamOuterCos;     float uBeamRange;     vec2 uWaterLightFade;   // x = start, y = end
+    float uWaterLightStrength;
+};
+
 uniform float uBeamStrength;
 uniform float uDebugWire; // 1 = debug cone (use GL_LINE in C++)
 
-uniform float uFogEnabled;
-uniform vec3  uFogColor;
-uniform float uFogDensity;
-
 void main()
 {
     float d = length(uViewPos - vPosWS);
@@ -52,7 +68,7 @@ void main()
 
     float mask = coneInside * wedge * core * along;
 
-    vec3 col = uBeamColor * (uBeamStrength * fadeDist) * mask;
+    vec3 col = uLanternColor * (uBeamStrength * fadeDist) * mask;
 
     // fog
     if (uFogEnabled > 0.5)
@@ -66,7 +82,7 @@ void main()
     // This prevents the giant “black box” occluding the world.
     if (uDebugWire > 0.5)
     {
-        FragColor = vec4(uBeamColor, 0.35);
+        FragColor = vec4(uLanternColor, 0.35);
         return;
     }
 
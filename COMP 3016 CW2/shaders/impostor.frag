@@ -0,0 +1,106 @@
+#version 410 core
+
+in vec2 vUV;
+in vec3 vPosWS;
+flat in mat3 vRot;
+flat in float vFade;
+
+out vec4 FragColor;
+
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
+
+// Lanterns, beam and sea level; written once per frame (SceneData in FrameUniforms.h)
+layout(std140) uniform SceneData
+{
+    vec4  uLanterns[256];    // xyz = position, w = intensity
+    vec3  uLanternColor;     float uSeaLevel;
+    vec3  uBeamDir;          float uBeamInnerCos;
+    float uBeamOuterCos;     float uBeamRange;     vec2 uWaterLightFade;   // x = start, y = end
+    float uWaterLightStrength;
+};
+
+uniform int   uLightIndex;   // this island's lantern in uLanterns, -1 = none
+
+uniform float uAmbientStrength;
+uniform float uSpecStrength;
+uniform float uShininess;
+
+uniform sampler2D uAlbedoAtlas;
+uniform sampler2D uNormalAtlas;
+
+// 4x4 ordered dither, 0..1; tree.frag keeps the texels this drops
+float Bayer4()
+{
+    const float m[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                  3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 p = ivec2(gl_FragCoord.xy) & 3;
+    return (m[p.y * 4 + p.x] + 0.5) / 16.0;
+}
+
+void main()
+{
+    if (Bayer4() >= vFade) discard;
+
+    vec4 albedoA = texture(uAlbedoAtlas, vUV);
+    if (albedoA.a < 0.5) discard;
+    vec3 albedo = albedoA.rgb;
+
+    // lit as tree.frag does the mesh, from the baked normal
+    vec3 N = normalize(vRot * (texture(uNormalAtlas, vUV).xyz * 2.0 - 1.0));
+    vec3 V = normalize(uViewPos - vPosWS);
+
+    vec3 L = normalize(-uLightDir);
+    float diff = max(dot(N, L), 0.0);
+
+    vec3 R = reflect(-L, N);
+    float spec = pow(max(dot(V, R), 0.0), uShininess);
+
+    vec3 color = uAmbientStrength * albedo + diff * albedo * uLightColor + uSpecStrength * spec * uLightColor;
+
+    if (uLightIndex >= 0)
+    {
+        vec4 lanternWS = uLanterns[uLightIndex];
+
+        vec3 LpVec = lanternWS.xyz - vPosWS;
+        float distP = length(LpVec);
+        vec3 Lp = (distP > 0.0001) ? (LpVec / distP) : vec3(0.0, 1.0, 0.0);
+
+        float atten = 1.0 / (1.0 + 0.05 * distP + 0.005 * distP * distP);
+        float diffP = max(dot(N, Lp), 0.0);
+
+        vec3 Hp = normalize(Lp + V);
+        float specP = pow(max(dot(N, Hp), 0.0), uShininess);
+
+        vec3 pointLight = (diffP * albedo + uSpecStrength * specP) * uLanternColor * atten * lanternWS.w;
+
+        vec3 lightToFrag = normalize(vPosWS - lanternWS.xyz);
+        float spot = smoothstep(uBeamOuterCos, uBeamInnerCos, dot(lightToFrag, normalize(uBeamDir)));
+        float beamAtten = 1.0 / (1.0 + 0.08 * distP + 0.01 * distP * distP);
+
+        color += pointLight * (0.08 + spot * beamAtten);
+    }
+
+    // fog and the distance fade of tree.frag
+    if (uFogEnabled > 0.5)
+    {
+        float d = length(uViewPos - vPosWS);
+        float f = clamp(exp(-(uFogDensity * d) * (uFogDensity * d)), 0.0, 1.0);
+        color = mix(uFogColor, color, f);
+
+        float fadeT = smoothstep(520.0, 220.0, d);
+        float n = fract(sin(dot(gl_FragCoord.xy, vec2(12.9898, 78.233))) * 43758.5453);
+        if (n > fadeT) discard;
+    }
+
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,68 @@
+#version 410 core
+
+// Far tree as one quad: the atlas frame shot from nearest the camera's direction (TreeImpostor).
+// Drawn as a 4-vertex strip per instance; the corner comes from gl_VertexID.
+layout(location=3) in mat4 iModel;
+
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
+
+uniform vec4 uTreeSphere;      // model-space sphere the frames were shot around
+uniform int uFrames;           // frames per atlas side
+uniform vec2 uImpostorFade;    // distances: the mesh starts to dither out, is gone
+
+out vec2 vUV;
+out vec3 vPosWS;
+flat out mat3 vRot;            // model to world rotation, for the atlas normals
+flat out float vFade;          // 0 = mesh only, 1 = impostor only
+
+vec2 HemiOctEncode(vec3 d)
+{
+    d.y = max(d.y, 0.0);
+    d /= abs(d.x) + abs(d.y) + abs(d.z);
+    return vec2(d.x + d.z, d.x - d.z);
+}
+
+vec3 HemiOctDecode(vec2 e)
+{
+    vec2 p = vec2(e.x + e.y, e.x - e.y) * 0.5;
+    return normalize(vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y));
+}
+
+void main()
+{
+    // trees are only turned about Y and scaled uniformly
+    float s = length(iModel[0].xyz);
+    mat3 rot = mat3(iModel) / s;
+
+    vec3 centre = (iModel * vec4(uTreeSphere.xyz, 1.0)).xyz;
+    vec3 toCam = transpose(rot) * (uViewPos - centre);
+
+    float last = float(uFrames - 1);
+    vec2 frame = floor((HemiOctEncode(normalize(toCam)) * 0.5 + 0.5) * last + 0.5);
+
+    // the quad lies in the frame's image plane, turned with the tree
+    vec3 dir = HemiOctDecode(frame / last * 2.0 - 1.0);
+    vec3 upRef = abs(dir.y) > 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, 1.0, 0.0);
+    vec3 right = normalize(cross(upRef, dir));
+    vec3 up = cross(dir, right);
+
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+    vPosWS = centre + rot * (right * corner.x + up * corner.y) * (uTreeSphere.w * s);
+    vUV = (frame + corner * 0.5 + 0.5) / float(uFrames);
+    vRot = rot;
+
+    float d = distance(iModel[3].xyz, uViewPos);
+    vFade = clamp((d - uImpostorFade.x) / max(uImpostorFade.y - uImpostorFade.x, 0.0001), 0.0, 1.0);
+
+    gl_Position = uProj * uView * vec4(vPosWS, 1.0);
+}
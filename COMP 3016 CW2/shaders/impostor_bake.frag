@@ -0,0 +1,19 @@
+#version 410 core
+
+in vec3 vNormalMS;
+in float vHeight01;
+
+layout(location=0) out vec4 oAlbedo;   // alpha = coverage
+layout(location=1) out vec4 oNormal;   // model space, as 0..1
+
+uniform float uTrunkFrac;
+
+void main()
+{
+    // same split as tree.frag
+    vec3 leafCol = vec3(36.0/255.0, 138.0/255.0, 41.0/255.0);
+    vec3 barkCol = vec3(86.0/255.0, 53.0/255.0, 4.0/255.0);
+
+    oAlbedo = vec4((vHeight01 < uTrunkFrac) ? barkCol : leafCol, 1.0);
+    oNormal = vec4(normalize(vNormalMS) * 0.5 + 0.5, 1.0);
+}
@@ -0,0 +1,19 @@
+#version 410 core
+
+// Tree mesh into one frame of the impostor atlas (TreeImpostor::Bake)
+layout(location=0) in vec3 aPos;
+layout(location=1) in vec3 aNormal;
+
+uniform mat4 uViewProj;
+uniform float uTreeMinY;
+uniform float uTreeMaxY;
+
+out vec3 vNormalMS;
+out float vHeight01;
+
+void main()
+{
+    vNormalMS = aNormal;
+    vHeight01 = (aPos.y - uTreeMinY) / max(uTreeMaxY - uTreeMinY, 0.0001);
+    gl_Position = uViewProj * vec4(aPos, 1.0);
+}
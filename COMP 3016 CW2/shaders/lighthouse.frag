@@ -4,19 +4,22 @@ in vec3 vNormalWS;
 
 out vec4 FragColor;
 
-uniform vec3  uViewPos;
-uniform vec3  uLightDir;
-uniform vec3  uLightColor;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
 
 uniform float uAmbientStrength;
 uniform float uSpecStrength;
 uniform float uShininess;
 
-// Fog
-uniform float uFogEnabled;
-uniform vec3  uFogColor;
-uniform float uFogDensity;
-
 // --- NIGHT SPOTLIGHT (beam source) ---
 uniform vec3  uSpotPos;
 uniform vec3  uSpotDir;          // should be normalized
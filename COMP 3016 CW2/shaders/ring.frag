@@ -5,14 +5,19 @@ out vec4 FragColor;
 
 uniform sampler2D uRingTex;
 
-uniform vec3  uViewPos;
-uniform vec3  uLightDir;
-uniform vec3  uLightColor;
-uniform float uAmbientStrength;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
 
-uniform float uFogEnabled;
-uniform vec3  uFogColor;
-uniform float uFogDensity;
+uniform float uAmbientStrength;
 
 void main()
 {
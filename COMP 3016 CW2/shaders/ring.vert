@@ -2,18 +2,42 @@
 layout(location=0) in vec3 aPos;
 layout(location=1) in vec3 aNormal;
 
-uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
+// Per instance (RingSystem::Ring): world position, then yaw, pitch, uniform scale
+layout(location=2) in vec3 iPosWS;
+layout(location=3) in vec3 iYawPitchScale;
+
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
 
 out vec3 vPosWS;
 out vec3 vNormalWS;
 
 void main(){
-    vec4 posWS = uModel * vec4(aPos, 1.0);
-    vPosWS = posWS.xyz;
+    // rotate(yaw around Y) * rotate(pitch around X), as RingSystem used to build on the CPU
+    float cy = cos(iYawPitchScale.x), sy = sin(iYawPitchScale.x);
+    float cp = cos(iYawPitchScale.y), sp = sin(iYawPitchScale.y);
+    mat3 rotY = mat3(cy, 0.0, -sy,
+                     0.0, 1.0, 0.0,
+                     sy, 0.0, cy);
+    mat3 rotX = mat3(1.0, 0.0, 0.0,
+                     0.0, cp, sp,
+                     0.0, -sp, cp);
+    mat3 R = rotY * rotX;
+
+    vec3 posWS = iPosWS + R * (aPos * iYawPitchScale.z);
+    vPosWS = posWS;
 
-    vNormalWS = mat3(transpose(inverse(uModel))) * aNormal;
+    // uniform scale: the rotation alone carries the normal
+    vNormalWS = R * aNormal;
 
-    gl_Position = uProj * uView * posWS;
+    gl_Position = uProj * uView * vec4(posWS, 1.0);
 }
\ No newline at end of file
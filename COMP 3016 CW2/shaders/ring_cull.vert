@@ -0,0 +1,28 @@
+#version 410 core
+
+// Ring cull pass: one point per live ring (RingSystem::Ring), no rasterisation. A ring survives
+// unless its bounding sphere is wholly outside one of the frustum planes.
+layout(location=0) in vec3 iPosWS;
+layout(location=1) in vec3 iYawPitchScale;
+
+uniform vec4 uFrustumPlanes[6];  // xyz = normal, w = distance; inside when dot(n, p) + w >= 0
+uniform float uRingRadius;       // bounding radius of the ring mesh at scale 1
+
+out vec3 vPosWS;
+out vec3 vYawPitchScale;
+flat out int vVisible;
+
+void main()
+{
+    float r = uRingRadius * iYawPitchScale.z;
+
+    int visible = 1;
+    for (int p = 0; p < 6; p++)
+    {
+        if (dot(uFrustumPlanes[p].xyz, iPosWS) + uFrustumPlanes[p].w < -r) visible = 0;
+    }
+
+    vPosWS = iPosWS;
+    vYawPitchScale = iYawPitchScale;
+    vVisible = visible;
+}
@@ -2,8 +2,19 @@
 in vec3 vDir;
 out vec4 FragColor;
 
-uniform vec3 uSunDir;   // direction light travels (FROM sun -> scene)
-uniform float uTime01;  // 0..1 time of day
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
+
+// uLightDir: direction light travels (FROM sun -> scene), uTime01: 0..1 time of day
 
 vec3 skyGradient(vec3 dir, float t01)
 {
@@ -17,7 +28,7 @@ vec3 skyGradient(vec3 dir, float t01)
     vec3 nightHorizon = vec3(0.05, 0.06, 0.10);
 
     // How "day" is it? based on sun height
-    float sunHeight = clamp(-uSunDir.y, 0.0, 1.0); // sun is "up" when -uSunDir.y is >0
+    float sunHeight = clamp(-uLightDir.y, 0.0, 1.0); // sun is "up" when -uLightDir.y is >0
     float dayAmount = smoothstep(0.05, 0.35, sunHeight);
 
     float h = clamp(dir.y * 0.5 + 0.5, 0.0, 1.0); // 0 bottom -> 1 top
@@ -36,7 +47,7 @@ void main()
     vec3 col = skyGradient(dir, uTime01);
 
     // Sun disc and glow
-    vec3 sunDir = normalize(-uSunDir); // direction from scene toward sun
+    vec3 sunDir = normalize(-uLightDir); // direction from scene toward sun
     float sunDot = max(dot(dir, sunDir), 0.0);
 
     float sunDisk = smoothstep(0.9995, 1.0, sunDot);     // small bright core
@@ -3,8 +3,17 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 vDir;
 
-uniform mat4 uView;
-uniform mat4 uProj;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
 
 void main()
 {
@@ -3,33 +3,53 @@
 in vec3 vNormalWS;
 in vec3 vPosWS;
 in float vHeight01;
+flat in float vImpostorFade;
 
 out vec4 FragColor;
 
-uniform vec3 uViewPos;
-uniform vec3 uLightDir;
-uniform vec3 uLightColor;
-
-uniform vec3  uPointLightPos;
-uniform vec3  uPointLightColor;
-uniform float uPointLightIntensity;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
+
+// Lanterns, beam and sea level; written once per frame (SceneData in FrameUniforms.h)
+layout(std140) uniform SceneData
+{
+    vec4  uLanterns[256];    // xyz = position, w = intensity
+    vec3  uLanternColor;     float uSeaLevel;
+    vec3  uBeamDir;          float uBeamInnerCos;
+    float uBeamOuterCos;     float uBeamRange;     vec2 uWaterLightFade;   // x = start, y = end
+    float uWaterLightStrength;
+};
 
-uniform vec3  uBeamDir;
-uniform float uBeamInnerCos;
-uniform float uBeamOuterCos;
+uniform int   uLightIndex;   // this island's lantern in uLanterns, -1 = none
 
 uniform float uAmbientStrength;
 uniform float uSpecStrength;
 uniform float uShininess;
 
-uniform float uFogEnabled;
-uniform vec3  uFogColor;
-uniform float uFogDensity;
-
 uniform float uTrunkFrac; // 0..1
 
+// 4x4 ordered dither, 0..1; impostor.frag keeps the texels this drops
+float Bayer4()
+{
+    const float m[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                  3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 p = ivec2(gl_FragCoord.xy) & 3;
+    return (m[p.y * 4 + p.x] + 0.5) / 16.0;
+}
+
 void main()
 {
+    if (Bayer4() < vImpostorFade) discard;
+
     vec3 leafCol = vec3(36.0/255.0, 138.0/255.0, 41.0/255.0);
     vec3 barkCol = vec3(86.0/255.0, 53.0/255.0, 4.0/255.0);
 
@@ -56,30 +76,35 @@ void main()
     // -------------------------
     // Lighthouse point light + spotlight mask
     // -------------------------
-    vec3 LpVec = uPointLightPos - vPosWS;
-    float distP = length(LpVec);
-    vec3 Lp = (distP > 0.0001) ? (LpVec / distP) : vec3(0.0, 1.0, 0.0);
+    if (uLightIndex >= 0)
+    {
+        vec4 lanternWS = uLanterns[uLightIndex];
+
+        vec3 LpVec = lanternWS.xyz - vPosWS;
+        float distP = length(LpVec);
+        vec3 Lp = (distP > 0.0001) ? (LpVec / distP) : vec3(0.0, 1.0, 0.0);
 
-    float atten = 1.0 / (1.0 + 0.05 * distP + 0.005 * distP * distP);
-    float diffP = max(dot(N, Lp), 0.0);
+        float atten = 1.0 / (1.0 + 0.05 * distP + 0.005 * distP * distP);
+        float diffP = max(dot(N, Lp), 0.0);
 
-    vec3 Hp = normalize(Lp + V);
-    float specP = pow(max(dot(N, Hp), 0.0), uShininess);
+        vec3 Hp = normalize(Lp + V);
+        float specP = pow(max(dot(N, Hp), 0.0), uShininess);
 
-    vec3 pointDiffuse  = diffP * albedo * uPointLightColor;
-    vec3 pointSpecular = uSpecStrength * specP * uPointLightColor;
+        vec3 pointDiffuse  = diffP * albedo * uLanternColor;
+        vec3 pointSpecular = uSpecStrength * specP * uLanternColor;
 
-    vec3 pointLight = (pointDiffuse + pointSpecular) * atten * uPointLightIntensity;
+        vec3 pointLight = (pointDiffuse + pointSpecular) * atten * lanternWS.w;
 
-    // beam cone mask
-    vec3 lightToFrag = normalize(vPosWS - uPointLightPos);
-    float cosAng = dot(lightToFrag, normalize(uBeamDir));
-    float spot = smoothstep(uBeamOuterCos, uBeamInnerCos, cosAng);
+        // beam cone mask
+        vec3 lightToFrag = normalize(vPosWS - lanternWS.xyz);
+        float cosAng = dot(lightToFrag, normalize(uBeamDir));
+        float spot = smoothstep(uBeamOuterCos, uBeamInnerCos, cosAng);
 
-    float beamAtten = 1.0 / (1.0 + 0.08 * distP + 0.01 * distP * distP);
-    float lantern = 0.08;
+        float beamAtten = 1.0 / (1.0 + 0.08 * distP + 0.01 * distP * distP);
+        float lantern = 0.08;
 
-    color += pointLight * (lantern + spot * beamAtten);
+        color += pointLight * (lantern + spot * beamAtten);
+    }
 
     // -------------------------
     // Fog + alpha fade
@@ -5,25 +5,39 @@ layout(location=1) in vec3 aNormal;
 layout(location=2) in vec2 aUV;
 layout(location=3) in mat4 iModel;
 
-uniform mat4 uView;
-uniform mat4 uProj;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
 
 uniform float uTreeMinY;
 uniform float uTreeMaxY;
+uniform vec2 uImpostorFade;    // distances: the mesh starts to dither out, is gone
 
 out vec3 vNormalWS;
 out vec3 vPosWS;
 out float vHeight01;
+flat out float vImpostorFade;  // share of this tree the impostor draws instead
 
 void main()
 {
     vec4 worldPos = iModel * vec4(aPos, 1.0);
     vPosWS = worldPos.xyz;
 
-    mat3 nrm = mat3(transpose(inverse(iModel)));
-    vNormalWS = normalize(nrm * aNormal);
+    // trees are only turned about Y and scaled uniformly, so the model matrix turns normals as is
+    vNormalWS = normalize(mat3(iModel) * aNormal);
 
     vHeight01 = (aPos.y - uTreeMinY) / max(uTreeMaxY - uTreeMinY, 0.0001);
 
+    float d = distance(iModel[3].xyz, uViewPos);
+    vImpostorFade = clamp((d - uImpostorFade.x) / max(uImpostorFade.y - uImpostorFade.x, 0.0001), 0.0, 1.0);
+
     gl_Position = uProj * uView * worldPos;
 }
@@ -0,0 +1,47 @@
+#version 410 core
+
+// Tree cull pass: one point per tree instance, no rasterisation. Picks the LODs the instance
+// draws with from its distance to the camera: bit k of vLods set = LOD k. Both LOD 1 and the
+// impostor (LOD 2) draw it inside the crossfade band; none do past the draw distance or outside
+// the frustum. The distance is the one tree.vert and impostor.vert fade by.
+layout(location=0) in mat4 iModel;
+
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
+
+uniform vec4 uFrustumPlanes[6];  // xyz = normal, w = distance; inside when dot(n, p) + w >= 0
+uniform vec4 uTreeSphere;        // bounding sphere of the tree mesh, model space
+uniform vec4 uLodDistances;      // x = end of LOD 0, y / z = crossfade to the impostor, w = draw distance
+
+out mat4 vModel;
+flat out int vLods;
+
+void main()
+{
+    vec3 c = (iModel * vec4(uTreeSphere.xyz, 1.0)).xyz;
+    float s = max(length(iModel[0].xyz), max(length(iModel[1].xyz), length(iModel[2].xyz)));
+    float r = uTreeSphere.w * s;
+
+    float d = distance(iModel[3].xyz, uViewPos);
+    int lods = 0;
+    if (d < uLodDistances.x) lods = 1;
+    else if (d < uLodDistances.z) lods = d < uLodDistances.y ? 2 : 2 | 4;
+    else if (d < uLodDistances.w) lods = 4;
+
+    for (int p = 0; p < 6; p++)
+    {
+        if (dot(uFrustumPlanes[p].xyz, c) + uFrustumPlanes[p].w < -r) lods = 0;
+    }
+
+    vModel = iModel;
+    vLods = lods;
+}
@@ -11,27 +11,34 @@ in VS_OUT {
 
 out vec4 FragColor;
 
-uniform vec3  uViewPos;
-uniform vec3  uLightDir;
-uniform vec3  uLightColor;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
+
+// Lanterns, beam and sea level; written once per frame (SceneData in FrameUniforms.h)
+layout(std140) uniform SceneData
+{
+    vec4  uLanterns[256];    // xyz = position, w = intensity
+    vec3  uLanternColor;     float uSeaLevel;
+    vec3  uBeamDir;          float uBeamInnerCos;
+    float uBeamOuterCos;     float uBeamRange;     vec2 uWaterLightFade;   // x = start, y = end
+    float uWaterLightStrength;
+};
 
 uniform float uAmbientStrength;
 uniform float uSpecStrength;
 uniform float uShininess;
 
-// Lighthouse / beam
-uniform vec3  uPointLightPos;
-uniform vec3  uPointLightColor;
-uniform float uPointLightIntensity;
-uniform vec3  uBeamDir;
-uniform float uBeamInnerCos;
-uniform float uBeamOuterCos;
-uniform float uBeamRange;
-
-// Fog
-uniform float uFogEnabled;
-uniform vec3  uFogColor;
-uniform float uFogDensity;
+// Lantern of this additive pass in uLanterns, -1 = none
+uniform int   uLightIndex;
 
 // NEW: when 1.0, output ONLY lighthouse contribution (for additive blending)
 uniform float uAdditiveOnly;
@@ -71,10 +78,20 @@ void main()
     // Lighthouse spotlight on water
     // (This is what we add during additive passes)
     // ----------------------------
-    vec3 LpVec = uPointLightPos - fs_in.worldPos;
+    vec3 lanternPos = vec3(0.0, -99999.0, 0.0);
+    float lanternIntensity = 0.0;
+    if (uLightIndex >= 0)
+    {
+        // water strength, faded out with the lantern's distance from the camera
+        lanternPos = uLanterns[uLightIndex].xyz;
+        float fade = 1.0 - smoothstep(uWaterLightFade.x, uWaterLightFade.y, length(lanternPos - uViewPos));
+        lanternIntensity = uWaterLightStrength * fade;
+    }
+
+    vec3 LpVec = lanternPos - fs_in.worldPos;
     float distP = length(LpVec);
 
-    if (uPointLightIntensity > 0.0001 && distP > 0.0001)
+    if (lanternIntensity > 0.0001 && distP > 0.0001)
     {
         // Hard stop (cheap early out)
         if (distP <= uBeamRange)
@@ -85,7 +102,7 @@ void main()
             float atten = 1.0 / (1.0 + 0.02 * distP + 0.0008 * distP * distP);
 
             // cone test
-            vec3 lightToFrag = normalize(fs_in.worldPos - uPointLightPos);
+            vec3 lightToFrag = normalize(fs_in.worldPos - lanternPos);
             float cosAng = dot(lightToFrag, normalize(uBeamDir));
             float spot = smoothstep(uBeamOuterCos, uBeamInnerCos, cosAng);
 
@@ -98,10 +115,10 @@ void main()
             vec3 Hp = normalize(Lp + V);
             float specP = pow(max(dot(N, Hp), 0.0), uShininess * 2.0);
 
-            vec3 pointDiffuse  = diffP * baseCol * uPointLightColor;
-            vec3 pointSpecular = (uSpecStrength * 1.5) * specP * uPointLightColor;
+            vec3 pointDiffuse  = diffP * baseCol * uLanternColor;
+            vec3 pointSpecular = (uSpecStrength * 1.5) * specP * uLanternColor;
 
-            vec3 beamLight = (pointDiffuse + pointSpecular) * atten * uPointLightIntensity;
+            vec3 beamLight = (pointDiffuse + pointSpecular) * atten * lanternIntensity;
 
             color += beamLight * spot * rangeFade;
         }
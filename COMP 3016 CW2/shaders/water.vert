@@ -1,15 +1,25 @@
 #version 410 core
 
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
+// Ocean clipmap level (Water in main.cpp): a (2n + 1)^2 grid around uClipOrigin with no vertex
+// attributes; the grid position comes from gl_VertexID.
 
-uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
+// Camera, sun, fog and time; written once per frame (FrameData in FrameUniforms.h)
+layout(std140) uniform FrameData
+{
+    mat4  uView;
+    mat4  uProj;
+    vec3  uViewPos;      float uTime;
+    vec3  uLightDir;     float uTime01;
+    vec3  uLightColor;   float uFogEnabled;
+    vec3  uFogColor;     float uFogDensity;
+    float uWaveStrength; float uWaveSpeed;
+};
 
-uniform float uTime;
-uniform float uWaveStrength;
-uniform float uWaveSpeed;
+uniform float uWaterHeight;
+uniform vec2 uClipOrigin;       // world xz of the level's centre
+uniform float uClipSpacing;
+uniform float uClipHalfCells;   // n; the grid runs -n..n
+uniform vec2 uMorphRange;       // x = morph start (xz distance from the camera, per axis), y = 1 / (end - start)
 
 out VS_OUT {
     vec3 worldPos;
@@ -30,25 +40,32 @@ void main()
 {
     float t = uTime * uWaveSpeed;
 
-    vec3 pos = aPos;
-    pos.y += wave(pos.xz, t) * uWaveStrength;
+    int side = int(uClipHalfCells) * 2 + 1;
+    vec2 grid = vec2(gl_VertexID % side, gl_VertexID / side) - uClipHalfCells;
+    vec2 wxz = uClipOrigin + grid * uClipSpacing;
+
+    // geomorph: odd vertices slide onto their even neighbours towards the level's edge, where
+    // they line up with the coarser level around it
+    vec2 d = abs(wxz - uViewPos.xz);
+    float morphK = clamp((max(d.x, d.y) - uMorphRange.x) * uMorphRange.y, 0.0, 1.0);
+    wxz -= mod(grid, 2.0) * uClipSpacing * morphK;
 
-    vec4 wp = uModel * vec4(pos, 1.0);
+    // Waves are a function of world xz, so the grid following the camera leaves them in place
+    vec4 wp = vec4(wxz.x, uWaterHeight + wave(wxz, t) * uWaveStrength, wxz.y, 1.0);
     vs_out.worldPos = wp.xyz;
 
     // Approx normal from wave derivatives (cheap + looks good)
     float eps = 0.05;
-    float hL = wave(pos.xz - vec2(eps, 0), t) * uWaveStrength;
-    float hR = wave(pos.xz + vec2(eps, 0), t) * uWaveStrength;
-    float hD = wave(pos.xz - vec2(0, eps), t) * uWaveStrength;
-    float hU = wave(pos.xz + vec2(0, eps), t) * uWaveStrength;
+    float hL = wave(wxz - vec2(eps, 0), t) * uWaveStrength;
+    float hR = wave(wxz + vec2(eps, 0), t) * uWaveStrength;
+    float hD = wave(wxz - vec2(0, eps), t) * uWaveStrength;
+    float hU = wave(wxz + vec2(0, eps), t) * uWaveStrength;
 
     vec3 dx = vec3(2.0 * eps, hR - hL, 0.0);
     vec3 dz = vec3(0.0, hU - hD, 2.0 * eps);
     vec3 n = normalize(cross(dz, dx));
 
-    mat3 normalMat = transpose(inverse(mat3(uModel)));
-    vs_out.normal = normalize(normalMat * n);
+    vs_out.normal = n;
 
     gl_Position = uProj * uView * wp;
 }
@@ -0,0 +1,241 @@
+// Headless world-generation benchmark: runs the same generation as the game (terrain, trees,
+// houses, lighthouse spots, rings) over a range of seeds without a window or GL context.
+//
+//   WorldGenBench [--seeds N] [--first S] [--threads T] [--grid G] [--trees N] [--expect HEX]
+//
+// Prints per-stage ms/island, heap allocations per island and a checksum over everything that
+// was generated. Every seed is generated a second time on the serial path and must match, and
+// with --expect the combined checksum must equal HEX; either failure exits with status 1.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "JobPool.h"
+#include "RingSystem.h"
+#include "WorldGen.h"
+
+//  Allocation counting
+
+namespace
+{
+    std::atomic<unsigned long long> gAllocCount{ 0 };
+    std::atomic<unsigned long long> gAllocBytes{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    gAllocCount.fetch_add(1, std::memory_order_relaxed);
+    gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+//  Bench
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point a, Clock::time_point b)
+    {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+
+    struct Options
+    {
+        int seeds = 8;
+        int firstSeed = 1337;
+        int threads = 1;
+        int grid = 0;                 // 0 = WorldConfig default
+        int trees = 0;                // per tree island, 0 = WorldConfig default
+        bool hasExpect = false;
+        uint64_t expect = 0;
+    };
+
+    // Summed over every island of every seed
+    struct StageTotals
+    {
+        double heightsMs = 0.0;
+        double normalsMs = 0.0;
+        double lodMs = 0.0;
+        double coastMs = 0.0;
+        double treesMs = 0.0;
+        double housesMs = 0.0;
+        double lighthouseMs = 0.0;
+        double ringsMs = 0.0;
+        double wallMs = 0.0;
+        unsigned long long allocs = 0;
+        unsigned long long allocBytes = 0;
+        int islands = 0;
+        int rings = 0;
+        int ringShortfall = 0;
+    };
+
+    bool ParseArgs(int argc, char** argv, Options& o)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string a = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (a == "--seeds" && hasValue) o.seeds = std::atoi(argv[++i]);
+            else if (a == "--first" && hasValue) o.firstSeed = std::atoi(argv[++i]);
+            else if (a == "--threads" && hasValue) o.threads = std::atoi(argv[++i]);
+            else if (a == "--grid" && hasValue) o.grid = std::atoi(argv[++i]);
+            else if (a == "--trees" && hasValue) o.trees = std::atoi(argv[++i]);
+            else if (a == "--expect" && hasValue)
+            {
+                o.expect = std::strtoull(argv[++i], nullptr, 16);
+                o.hasExpect = true;
+            }
+            else
+            {
+                std::cerr << "Usage: WorldGenBench [--seeds N] [--first S] [--threads T] [--grid G] [--trees N] [--expect HEX]\n"
+                    << "  --threads 0 uses every hardware thread, 1 is the serial path\n";
+                return false;
+            }
+        }
+        return o.seeds > 0;
+    }
+
+    // One world: islands + rings, checksummed the same way as the game's [GenScaling] log
+    uint64_t GenerateWorld(const WorldGenerator& gen, int seed, JobPool* pool, StageTotals* totals)
+    {
+        std::vector<Island> islands;
+        RingSystem rings;
+
+        unsigned long long allocs0 = gAllocCount.load();
+        unsigned long long bytes0 = gAllocBytes.load();
+
+        auto t0 = Clock::now();
+        gen.GenerateIslands(seed, pool, nullptr, islands);
+        auto t1 = Clock::now();
+        gen.SpawnRings(islands, seed, rings);
+        auto t2 = Clock::now();
+
+        if (totals)
+        {
+            totals->allocs += gAllocCount.load() - allocs0;
+            totals->allocBytes += gAllocBytes.load() - bytes0;
+            totals->wallMs += ElapsedMs(t0, t2);
+            totals->ringsMs += ElapsedMs(t1, t2);
+            totals->islands += (int)islands.size();
+            totals->rings += (int)rings.Rings().size();
+            totals->ringShortfall += rings.GetSpawnShortfall();
+
+            for (const Island& isl : islands)
+            {
+                const Terrain::BuildTimings& tt = isl.terrain.LastBuildTimings();
+                totals->heightsMs += tt.heightsMs;
+                totals->normalsMs += tt.normalsMs;
+                totals->lodMs += tt.lodMs;
+                totals->coastMs += tt.coastMs;
+                totals->treesMs += isl.genTimings.treesMs;
+                totals->housesMs += isl.genTimings.housesMs;
+                totals->lighthouseMs += isl.genTimings.lighthouseMs;
+            }
+        }
+
+        return RingsChecksum(WorldChecksum(islands), rings);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) return 2;
+
+    WorldConfig cfg;
+    if (opt.grid > 0) cfg.terrainGrid = opt.grid;
+    if (opt.trees > 0)
+    {
+        // keep the same ground coverage: spacing shrinks with the square root of the count
+        cfg.treeMinSpacing *= std::sqrt((float)cfg.treesPerIsland / (float)opt.trees);
+        cfg.treesPerIsland = opt.trees;
+    }
+
+    // Stand-ins for the game's models: generation only needs to know they exist
+    WorldGenAssets assets;
+    assets.treesLoaded = true;
+    assets.treePivotMS = glm::vec3(0.0f);
+    assets.lighthouseLoaded = true;
+    assets.houseVariants = 3;
+
+    WorldGenerator gen(cfg, assets);
+
+    std::unique_ptr<JobPool> pool;
+    if (opt.threads != 1) pool = std::make_unique<JobPool>(opt.threads);
+
+    std::cout << "[Bench] seeds=" << opt.seeds << " first=" << opt.firstSeed
+        << " threads=" << (pool ? pool->ThreadCount() : 1)
+        << " islands/seed=" << cfg.islandCount << " grid=" << cfg.terrainGrid
+        << " trees/island=" << cfg.treesPerIsland << "\n";
+
+    StageTotals totals;
+    uint64_t combined = 1469598103934665603ull;
+    int mismatches = 0;
+
+    for (int s = 0; s < opt.seeds; s++)
+    {
+        int seed = opt.firstSeed + s;
+        uint64_t sum = GenerateWorld(gen, seed, pool.get(), &totals);
+
+        // Determinism: the serial reference path must produce the same world
+        uint64_t serialSum = GenerateWorld(gen, seed, nullptr, nullptr);
+        if (serialSum != sum)
+        {
+            mismatches++;
+            std::cout << "[Bench] seed=" << seed << " checksum=" << std::hex << sum
+                << " serial=" << serialSum << std::dec << " (MISMATCH)\n";
+        }
+
+        combined = HashBytes(combined, &sum, sizeof(sum));
+    }
+
+    int n = std::max(totals.islands, 1);
+    std::cout << "[Bench] ms/island:"
+        << " heights=" << totals.heightsMs / n
+        << " normals=" << totals.normalsMs / n
+        << " lod=" << totals.lodMs / n
+        << " coast=" << totals.coastMs / n
+        << " trees=" << totals.treesMs / n
+        << " houses=" << totals.housesMs / n
+        << " lighthouse=" << totals.lighthouseMs / n
+        << " rings=" << totals.ringsMs / n
+        << " wall=" << totals.wallMs / n << "\n";
+
+    std::cout << "[Bench] allocs/island=" << totals.allocs / n
+        << " allocKB/island=" << totals.allocBytes / 1024 / n << "\n";
+
+    std::cout << "[Bench] rings=" << totals.rings << " shortfall=" << totals.ringShortfall << "\n";
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)combined);
+    std::cout << "[Bench] checksum=" << hex
+        << (mismatches ? " (serial MISMATCH)" : " (matches serial)") << "\n";
+
+    bool ok = mismatches == 0;
+    if (opt.hasExpect && combined != opt.expect)
+    {
+        std::cout << "[Bench] expected " << std::hex << opt.expect << std::dec << ": MISMATCH\n";
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}